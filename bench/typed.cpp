@@ -0,0 +1,105 @@
+/**
+ * @file typed.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Compares the runtime grammar in parse.cpp against the statically typed grammar in typed.hpp.
+ * @date 2022-08-28
+ *
+ * Build with the library sources, e.g. `g++ -std=c++20 -O2 -Isrc bench/typed.cpp src/lexer.cpp src/parse.cpp`.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "typed.hpp"
+
+using namespace burbank;
+
+/**
+ * @brief Whether two ASTs have the same shape, names and token spans.
+ */
+static bool same(const parse::ast& a, const parse::ast& b) noexcept
+{
+    if(a.name != b.name
+        or a.begin != b.begin
+        or a.end != b.end
+        or a.branches.size() != b.branches.size()
+    )
+        return false;
+
+    for(std::size_t i = 0; i < a.branches.size(); ++i)
+        if(not same(a.branches[i], b.branches[i]))
+            return false;
+
+    return true;
+}
+
+/**
+ * @brief Runs `parser` `iterations` times and returns the average time in microseconds.
+ */
+template<typename PARSER>
+static double measure(const std::size_t iterations, PARSER parser) noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for(std::size_t i = 0; i < iterations; ++i)
+        parser();
+
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t copies = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    const std::string unit =
+        "static const unsigned long table[4] = { 1, 2, 3, 4 };\n"
+        "extern int total;\n"
+        "int distance(int x, int y)\n"
+        "{\n"
+        "    int dx = x - 1, dy = y * 2 + table[x & 3];\n"
+        "    if(dx < dy) return dx << 1; else return dy >> 1;\n"
+        "    total += dx ? dy : -dx;\n"
+        "    log(\"distance\", dx, dy);\n"
+        "    return dx * dx + dy * dy;\n"
+        "}\n";
+
+    std::string text;
+    for(std::size_t i = 0; i < copies; ++i)
+        text += unit;
+
+    lexer lex(lexer::tokens);
+    const std::vector<lexer::token> tokens = lex.tokenize(text);
+
+    const std::optional<parse::ast> dynamic = parse::nonterminals[translationUnit]->match(tokens, tokens.cbegin());
+    const std::optional<parse::ast> fixed = typed::match<translationUnit>(tokens, tokens.cbegin());
+
+    if(dynamic.has_value() != fixed.has_value()
+        or (dynamic.has_value() and not same(*dynamic, *fixed))
+    )
+    {
+        std::cerr << "The runtime and typed grammars produced different ASTs\n";
+        return EXIT_FAILURE;
+    }
+
+    const double dynamicTime = measure(iterations, [&]
+    {
+        parse::nonterminals[translationUnit]->match(tokens, tokens.cbegin());
+    });
+
+    const double typedTime = measure(iterations, [&]
+    {
+        typed::match<translationUnit>(tokens, tokens.cbegin());
+    });
+
+    std::cout
+        << tokens.size() << " tokens, " << iterations << " iterations\n"
+        << "runtime grammar: " << dynamicTime << " us/parse\n"
+        << "typed grammar:   " << typedTime << " us/parse\n"
+        << "speedup:         " << dynamicTime / typedTime << "x\n";
+
+    return EXIT_SUCCESS;
+}
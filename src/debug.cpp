@@ -180,4 +180,5 @@ std::map<nonterminal, std::string> debug::nonterminalNames = {
     {translationUnit, "translationUnit"},
     {externalDeclaration, "externalDeclaration"},
     {functionDefinition, "functionDefinition"},
+    {error, "error"},
 };
\ No newline at end of file
@@ -0,0 +1,917 @@
+/**
+ * @file lalr.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Table-driven LALR(1) parser with GLR fallback, generated from the combinator grammar in parse.cpp.
+ * @date 2022-08-29
+ */
+
+#include "lalr.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+using namespace burbank;
+using burbank::lalr::table;
+
+namespace
+{
+    /**
+     * @brief A set of terminals, plus one extra bit used as the "propagated" marker while computing lookaheads.
+     */
+    using lookahead = std::vector<std::uint64_t>;
+
+    inline void set(lookahead& bits, const std::size_t i) noexcept
+    {
+        bits[i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+
+    inline bool test(const lookahead& bits, const std::size_t i) noexcept
+    {
+        return bits[i / 64] >> (i % 64) & 1;
+    }
+
+    /**
+     * @brief `to |= from`. Returns whether `to` changed.
+     */
+    inline bool merge(lookahead& to, const lookahead& from) noexcept
+    {
+        bool changed = false;
+
+        for(std::size_t i = 0; i < to.size(); ++i)
+        {
+            const std::uint64_t merged = to[i] | from[i];
+            changed |= merged != to[i];
+            to[i] = merged;
+        }
+
+        return changed;
+    }
+
+    /**
+     * @brief A node of the parse forest built while parsing. The AST is only built once, from the accepted derivation, so forked stacks share subtrees instead of copying them.
+     */
+    struct derivation
+    {
+        /**
+         * @brief The production this was reduced by, or -1 for a shifted terminal.
+         */
+        int production;
+
+        /**
+         * @brief The terminal this is, if `production == -1`.
+         */
+        int terminal;
+
+        std::uint32_t begin, end;
+
+        mutable std::vector<std::shared_ptr<const derivation>> children;
+
+        /**
+         * @brief Releases long chains (e.g. the left spine of a `rep`) iteratively so that destroying them cannot overflow the stack.
+         */
+        ~derivation(void) noexcept
+        {
+            std::vector<std::shared_ptr<const derivation>> pending = std::move(this->children);
+
+            while(not pending.empty())
+            {
+                std::shared_ptr<const derivation> last = std::move(pending.back());
+                pending.pop_back();
+
+                if(last and last.use_count() == 1)
+                    for(auto& child : last->children)
+                        pending.push_back(std::move(child));
+            }
+        }
+    };
+
+    /**
+     * @brief One entry of a (possibly shared) GLR stack.
+     */
+    struct frame
+    {
+        std::uint32_t state;
+        std::shared_ptr<const derivation> value;
+        std::shared_ptr<const frame> below;
+
+        /**
+         * @brief Hash of the states from here to the bottom of the stack, used to find stacks that can be merged.
+         */
+        std::size_t hash;
+        std::size_t depth;
+    };
+
+    /**
+     * @brief Whether two stacks have the same sequence of states, i.e. will behave identically from now on.
+     */
+    bool equivalent(const frame* a, const frame* b) noexcept
+    {
+        if(a->hash != b->hash or a->depth != b->depth)
+            return false;
+
+        for(; a != b; a = a->below.get(), b = b->below.get())
+            if(a->state != b->state)
+                return false;
+
+        return true;
+    }
+
+    std::shared_ptr<const derivation> derive(
+        const int production,
+        const int terminal,
+        const std::uint32_t begin,
+        const std::uint32_t end,
+        std::vector<std::shared_ptr<const derivation>> children = {}
+    ) noexcept
+    {
+        auto result = std::make_shared<derivation>();
+
+        result->production = production;
+        result->terminal = terminal;
+        result->begin = begin;
+        result->end = end;
+        result->children = std::move(children);
+
+        return result;
+    }
+
+    std::shared_ptr<const frame> push(
+        const std::uint32_t state,
+        std::shared_ptr<const derivation> value,
+        std::shared_ptr<const frame> below
+    ) noexcept
+    {
+        const std::size_t hash = below->hash * 1000003 ^ state;
+        const std::size_t depth = below->depth + 1;
+
+        return std::make_shared<const frame>(frame {
+            state,
+            std::move(value),
+            std::move(below),
+            hash,
+            depth
+        });
+    }
+}
+
+int table::terminal(const std::optional<nonterminal> kind, const std::string& text)
+{
+    if(kind.has_value())
+    {
+        if(const auto found = this->_kinds.find(*kind); found != this->_kinds.end())
+            return found->second;
+
+        this->_terminals.push_back(kind);
+        return this->_kinds[*kind] = this->_terminals.size() - 1;
+    }
+    else
+    {
+        if(const auto found = this->_literals.find(text); found != this->_literals.end())
+            return found->second;
+
+        this->_terminals.push_back(std::nullopt);
+        return this->_literals[text] = this->_terminals.size() - 1;
+    }
+}
+
+int table::symbol(void)
+{
+    return this->_nonterminalCount++;
+}
+
+int table::reference(
+    const nonterminal name,
+    const std::map<nonterminal, parse::abstractSyntax*>& rules
+)
+{
+    if(const auto found = this->_references.find(name); found != this->_references.end())
+        return found->second;
+
+    // Register the symbol before lowering its rule, which may refer back to it
+    const int result = this->_references[name] = this->symbol();
+
+    if(rules.contains(name))
+    {
+        const int body = this->lower(rules.at(name), rules);
+        this->_productions.push_back({result, {body}, wrap, name});
+    }
+
+    return result;
+}
+
+/*
+While lowering, terminals are stored as `~terminal` and nonterminals as their index; `build` renumbers them once the number of terminals is known.
+*/
+int table::lower(
+    const parse::abstractSyntax* syntax,
+    const std::map<nonterminal, parse::abstractSyntax*>& rules
+)
+{
+    if(const auto found = this->_lowered.find(syntax); found != this->_lowered.end())
+        return found->second;
+
+    int result;
+
+    if(const auto x = dynamic_cast<const parse::lit*>(syntax))
+        result = ~this->terminal(std::nullopt, x->data);
+
+    else if(const auto x = dynamic_cast<const parse::token*>(syntax))
+        result = ~this->terminal(x->data, "");
+
+    else if(const auto x = dynamic_cast<const parse::ref*>(syntax))
+        result = this->reference(x->data, rules);
+
+    // A lazily parsed body is parsed in full here
+    else if(const auto x = dynamic_cast<const parse::lazy*>(syntax))
+        result = this->reference(x->data, rules);
+
+    // Error recovery needs backtracking; here it only matches what it wraps
+    else if(const auto x = dynamic_cast<const parse::recover*>(syntax))
+        result = this->lower(x->data, rules);
+
+    // There is no typedef table here, so a typedef name never matches and any identifier is an ordinary one
+    else if(const auto x = dynamic_cast<const parse::typedefToken*>(syntax))
+        result = x->data ? this->symbol() : ~this->terminal(identifier, "");
+
+    else if(const auto x = dynamic_cast<const parse::declare*>(syntax))
+        result = this->lower(x->data, rules);
+
+    else if(const auto x = dynamic_cast<const parse::scope*>(syntax))
+        result = this->lower(x->data, rules);
+
+    else if(const auto x = dynamic_cast<const parse::opt*>(syntax))
+    {
+        result = this->symbol();
+        const int body = this->lower(x->data, rules);
+
+        this->_productions.push_back({result, {body}, pass});
+        this->_productions.push_back({result, {}, empty});
+    }
+
+    else if(const auto x = dynamic_cast<const parse::rep*>(syntax))
+    {
+        result = this->symbol();
+        const int body = this->lower(x->data, rules);
+
+        // Left recursion keeps the LR stack flat no matter how many repeats there are
+        this->_productions.push_back({result, {body}, first});
+        this->_productions.push_back({result, {result, body}, next});
+    }
+
+    else if(const auto x = dynamic_cast<const parse::oneOf*>(syntax))
+    {
+        result = this->symbol();
+
+        // Alternatives are added in order, so earlier alternatives win reduce/reduce conflicts
+        for(const parse::abstractSyntax* alternative : x->data)
+        {
+            const int body = this->lower(alternative, rules);
+            this->_productions.push_back({result, {body}, pass});
+        }
+    }
+
+    else if(const auto x = dynamic_cast<const parse::list*>(syntax))
+    {
+        result = this->symbol();
+        std::vector<int> rhs;
+
+        for(const parse::abstractSyntax* item : x->data)
+            rhs.push_back(this->lower(item, rules));
+
+        this->_productions.push_back({result, rhs, sequence});
+    }
+
+    else if(const auto x = dynamic_cast<const parse::csl*>(syntax))
+    {
+        result = this->symbol();
+        const int body = this->lower(x->data, rules);
+        const int comma = ~this->terminal(std::nullopt, ",");
+
+        this->_productions.push_back({result, {body}, first});
+        this->_productions.push_back({result, {result, comma, body}, next});
+    }
+
+    // Unknown syntax; a nonterminal with no productions never matches
+    else
+        result = this->symbol();
+
+    return this->_lowered[syntax] = result;
+}
+
+table::table(
+    const nonterminal start /* = translationUnit */,
+    const std::map<nonterminal, parse::abstractSyntax*>& rules /* = parse::nonterminals */
+)
+{
+    // Terminal 0 is the end of the input
+    this->_terminals.push_back(std::nullopt);
+
+    // Production 0 is the augmented start production, filled in once the start symbol is known
+    this->_productions.push_back({});
+
+    const int body = rules.contains(start)
+        ? this->lower(rules.at(start), rules)
+        : this->symbol();
+
+    this->_productions[0] = {this->symbol(), {body}, pass};
+
+    this->_lowered.clear();
+    this->_references.clear();
+
+    this->build();
+}
+
+void table::build(void)
+{
+    const int terminals = this->_terminals.size();
+    const int nonterminals = this->_nonterminalCount;
+    const std::size_t words = (terminals + 1 + 63) / 64;
+
+    // The marker for lookaheads that propagate from a kernel item rather than arising spontaneously
+    const int propagated = terminals;
+
+    const auto renumber = [terminals](const int symbol) noexcept
+    {
+        return symbol < 0 ? ~symbol : terminals + symbol;
+    };
+
+    for(production& p : this->_productions)
+    {
+        p.lhs = renumber(p.lhs);
+
+        for(int& symbol : p.rhs)
+            symbol = renumber(symbol);
+    }
+
+    const auto isTerminal = [terminals](const int symbol) noexcept
+    {
+        return symbol < terminals;
+    };
+
+    std::vector<std::vector<int>> byLhs(nonterminals);
+
+    for(std::size_t p = 0; p < this->_productions.size(); ++p)
+        byLhs[this->_productions[p].lhs - terminals].push_back(p);
+
+    /* FIRST sets and nullability */
+
+    std::vector<lookahead> firsts(nonterminals, lookahead(words));
+    std::vector<bool> nullable(nonterminals, false);
+
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+
+        for(const production& p : this->_productions)
+        {
+            lookahead& first = firsts[p.lhs - terminals];
+            bool allNullable = true;
+
+            for(const int symbol : p.rhs)
+            {
+                if(isTerminal(symbol))
+                {
+                    if(not test(first, symbol))
+                    {
+                        set(first, symbol);
+                        changed = true;
+                    }
+
+                    allNullable = false;
+                    break;
+                }
+
+                changed |= merge(first, firsts[symbol - terminals]);
+
+                if(not nullable[symbol - terminals])
+                {
+                    allNullable = false;
+                    break;
+                }
+            }
+
+            if(allNullable and not nullable[p.lhs - terminals])
+                nullable[p.lhs - terminals] = changed = true;
+        }
+    }
+
+    /* LR(0) items: item `base[p] + dot` is production `p` with the dot before `rhs[dot]` */
+
+    std::vector<int> base, itemProduction, itemDot;
+
+    for(std::size_t p = 0; p < this->_productions.size(); ++p)
+    {
+        base.push_back(itemProduction.size());
+
+        for(std::size_t dot = 0; dot <= this->_productions[p].rhs.size(); ++dot)
+        {
+            itemProduction.push_back(p);
+            itemDot.push_back(dot);
+        }
+    }
+
+    const std::size_t items = itemProduction.size();
+
+    // FIRST and nullability of everything after the dot of each item
+    std::vector<lookahead> restFirst(items, lookahead(words));
+    std::vector<bool> restNullable(items, true);
+
+    for(std::size_t p = 0; p < this->_productions.size(); ++p)
+    {
+        const std::vector<int>& rhs = this->_productions[p].rhs;
+
+        for(int dot = rhs.size() - 1; dot >= 0; --dot)
+        {
+            const int item = base[p] + dot;
+
+            if(isTerminal(rhs[dot]))
+            {
+                set(restFirst[item], rhs[dot]);
+                restNullable[item] = false;
+            }
+            else
+            {
+                restFirst[item] = firsts[rhs[dot] - terminals];
+
+                if(nullable[rhs[dot] - terminals])
+                    merge(restFirst[item], restFirst[item + 1]);
+                else
+                    restNullable[item] = false;
+            }
+
+            restNullable[item] = restNullable[item] and restNullable[item + 1];
+        }
+    }
+
+    const auto after = [&](const int item) noexcept -> std::optional<int>
+    {
+        const std::vector<int>& rhs = this->_productions[itemProduction[item]].rhs;
+
+        if(itemDot[item] < int(rhs.size()))
+            return rhs[itemDot[item]];
+        else
+            return std::nullopt;
+    };
+
+    /* LR(0) automaton */
+
+    std::vector<std::vector<int>> kernels {{base[0]}};
+    std::vector<std::vector<int>> closures;
+    std::vector<std::vector<std::pair<int, int>>> transitions;
+    std::map<std::vector<int>, int> states {{kernels[0], 0}};
+    std::vector<std::size_t> added(nonterminals, 0);
+
+    for(std::size_t state = 0; state < kernels.size(); ++state)
+    {
+        std::vector<int> closure = kernels[state];
+
+        for(std::size_t i = 0; i < closure.size(); ++i)
+        {
+            const std::optional<int> symbol = after(closure[i]);
+
+            if(symbol.has_value()
+                and not isTerminal(*symbol)
+                and added[*symbol - terminals] != state + 1
+            )
+            {
+                added[*symbol - terminals] = state + 1;
+
+                for(const int p : byLhs[*symbol - terminals])
+                    closure.push_back(base[p]);
+            }
+        }
+
+        std::map<int, std::vector<int>> successors;
+
+        for(const int item : closure)
+            if(const std::optional<int> symbol = after(item))
+                successors[*symbol].push_back(item + 1);
+
+        std::vector<std::pair<int, int>> edges;
+
+        for(auto& [symbol, kernel] : successors)
+        {
+            std::sort(kernel.begin(), kernel.end());
+
+            const auto [found, inserted] = states.try_emplace(kernel, kernels.size());
+
+            if(inserted)
+                kernels.push_back(kernel);
+
+            edges.emplace_back(symbol, found->second);
+        }
+
+        closures.push_back(std::move(closure));
+        transitions.push_back(std::move(edges));
+    }
+
+    this->_states = kernels.size();
+
+    const auto transition = [&](const int state, const int symbol) noexcept
+    {
+        const auto& edges = transitions[state];
+        return std::lower_bound(
+            edges.begin(),
+            edges.end(),
+            std::make_pair(symbol, -1)
+        )->second;
+    };
+
+    const auto kernelIndex = [&](const int state, const int item) noexcept
+    {
+        const auto& kernel = kernels[state];
+        return std::lower_bound(kernel.begin(), kernel.end(), item) - kernel.begin();
+    };
+
+    /* LR(1) closure of a state, given lookaheads for its kernel items */
+
+    std::vector<int> position(items, -1);
+
+    const auto closeLookaheads = [&](const int state, std::vector<lookahead>& lookaheads)
+    {
+        const std::vector<int>& closure = closures[state];
+
+        for(std::size_t i = 0; i < closure.size(); ++i)
+            position[closure[i]] = i;
+
+        std::vector<std::size_t> work;
+        std::vector<bool> queued(closure.size(), false);
+
+        for(std::size_t i = 0; i < kernels[state].size(); ++i)
+        {
+            work.push_back(i);
+            queued[i] = true;
+        }
+
+        lookahead spread(words);
+
+        while(not work.empty())
+        {
+            const std::size_t i = work.back();
+            work.pop_back();
+            queued[i] = false;
+
+            const std::optional<int> symbol = after(closure[i]);
+
+            if(not symbol.has_value() or isTerminal(*symbol))
+                continue;
+
+            spread = restFirst[closure[i] + 1];
+
+            if(restNullable[closure[i] + 1])
+                merge(spread, lookaheads[i]);
+
+            for(const int p : byLhs[*symbol - terminals])
+            {
+                const int j = position[base[p]];
+
+                if(merge(lookaheads[j], spread) and not queued[j])
+                {
+                    work.push_back(j);
+                    queued[j] = true;
+                }
+            }
+        }
+
+        for(const int item : closure)
+            position[item] = -1;
+    };
+
+    /* LALR(1) lookaheads by spontaneous generation and propagation */
+
+    std::vector<std::size_t> kernelOffset;
+    std::size_t kernelItems = 0;
+
+    for(const auto& kernel : kernels)
+    {
+        kernelOffset.push_back(kernelItems);
+        kernelItems += kernel.size();
+    }
+
+    std::vector<lookahead> lookaheads(kernelItems, lookahead(words));
+    std::vector<std::vector<std::size_t>> propagates(kernelItems);
+
+    set(lookaheads[0], 0);
+
+    for(std::size_t state = 0; state < kernels.size(); ++state)
+    {
+        for(std::size_t k = 0; k < kernels[state].size(); ++k)
+        {
+            std::vector<lookahead> closed(closures[state].size(), lookahead(words));
+            set(closed[k], propagated);
+            closeLookaheads(state, closed);
+
+            for(std::size_t i = 0; i < closed.size(); ++i)
+            {
+                const int item = closures[state][i];
+                const std::optional<int> symbol = after(item);
+
+                if(not symbol.has_value())
+                    continue;
+
+                const int target = transition(state, *symbol);
+                const std::size_t to = kernelOffset[target] + kernelIndex(target, item + 1);
+
+                if(test(closed[i], propagated))
+                    propagates[kernelOffset[state] + k].push_back(to);
+
+                for(int t = 0; t < terminals; ++t)
+                    if(test(closed[i], t))
+                        set(lookaheads[to], t);
+            }
+        }
+    }
+
+    for(bool changed = true; changed;)
+    {
+        changed = false;
+
+        for(std::size_t from = 0; from < kernelItems; ++from)
+            for(const std::size_t to : propagates[from])
+                changed |= merge(lookaheads[to], lookaheads[from]);
+    }
+
+    /* Action and goto tables */
+
+    this->_gotos.assign(kernels.size() * nonterminals, -1);
+    this->_actions.assign(kernels.size() * terminals, {0, 0});
+
+    std::vector<std::vector<action>> cell(terminals);
+
+    for(std::size_t state = 0; state < kernels.size(); ++state)
+    {
+        for(auto& actions : cell)
+            actions.clear();
+
+        for(const auto& [symbol, target] : transitions[state])
+        {
+            if(isTerminal(symbol))
+                cell[symbol].push_back({action::shift, std::uint32_t(target)});
+            else
+                this->_gotos[state * nonterminals + symbol - terminals] = target;
+        }
+
+        std::vector<lookahead> closed(closures[state].size(), lookahead(words));
+
+        for(std::size_t k = 0; k < kernels[state].size(); ++k)
+            closed[k] = lookaheads[kernelOffset[state] + k];
+
+        closeLookaheads(state, closed);
+
+        // Reductions in production order, so earlier alternatives are preferred
+        std::vector<std::pair<int, std::size_t>> complete;
+
+        for(std::size_t i = 0; i < closed.size(); ++i)
+            if(not after(closures[state][i]).has_value())
+                complete.emplace_back(itemProduction[closures[state][i]], i);
+
+        std::sort(complete.begin(), complete.end());
+
+        for(const auto& [p, i] : complete)
+            for(int t = 0; t < terminals; ++t)
+                if(test(closed[i], t))
+                    cell[t].push_back(p == 0
+                        ? action {action::accept, 0}
+                        : action {action::reduce, std::uint32_t(p)}
+                    );
+
+        for(int t = 0; t < terminals; ++t)
+        {
+            this->_actions[state * terminals + t] = {
+                this->_actionList.size(),
+                this->_actionList.size() + cell[t].size()
+            };
+
+            this->_actionList.insert(this->_actionList.end(), cell[t].begin(), cell[t].end());
+
+            if(cell[t].size() > 1)
+                ++this->_conflicts;
+        }
+    }
+}
+
+std::optional<parse::ast> table::match(
+    const std::vector<lexer::token>& tokens,
+    const std::size_t maxStacks /* = 64 */
+) const noexcept
+{
+    const std::size_t terminals = this->_terminals.size();
+
+    // Stops runaway reductions; a well-formed grammar never gets close to this
+    const std::size_t maxReductions = 1 << 20;
+
+    std::vector<std::shared_ptr<const frame>> active {
+        std::make_shared<const frame>(frame {0, nullptr, nullptr, 0, 0})
+    };
+
+    std::vector<std::shared_ptr<const frame>> shifted;
+    std::shared_ptr<const derivation> accepted;
+    std::vector<int> candidates;
+    std::size_t reductions;
+
+    for(std::uint32_t pos = 0; pos <= tokens.size(); ++pos)
+    {
+        // A token can stand for more than one terminal, e.g. `_Atomic` is both an identifier and a string literal in the grammar
+        candidates.clear();
+
+        if(pos == tokens.size())
+            candidates.push_back(0);
+        else
+        {
+            const lexer::token& token = tokens[pos];
+
+            if(const auto found = this->_literals.find(std::string_view(token.begin, token.end)); found != this->_literals.end())
+                candidates.push_back(found->second);
+
+            if(const auto found = this->_kinds.find(token.name); found != this->_kinds.end())
+                candidates.push_back(found->second);
+        }
+
+        shifted.clear();
+        reductions = 0;
+
+        // Performs every action available to a stack, recursing into the stacks produced by reductions
+        const auto expand = [&](const auto& self, const std::shared_ptr<const frame>& top) noexcept -> void
+        {
+            for(const int terminal : candidates)
+            {
+                const auto [first, last] = this->_actions[top->state * terminals + terminal];
+
+                for(std::uint32_t a = first; a < last; ++a)
+                {
+                    const action& act = this->_actionList[a];
+
+                    if(act.type == action::shift)
+                    {
+                        shifted.push_back(push(
+                            act.target,
+                            derive(-1, terminal, pos, pos + 1),
+                            top
+                        ));
+                    }
+                    else if(act.type == action::accept)
+                    {
+                        if(not accepted)
+                            accepted = top->value;
+                    }
+                    else if(++reductions < maxReductions)
+                    {
+                        const production& p = this->_productions[act.target];
+                        std::vector<std::shared_ptr<const derivation>> children(p.rhs.size());
+                        const frame* below = top.get();
+                        std::shared_ptr<const frame> base = top;
+
+                        for(std::size_t i = p.rhs.size(); i-- > 0;)
+                        {
+                            children[i] = below->value;
+                            base = below->below;
+                            below = base.get();
+                        }
+
+                        const std::int32_t target = this->_gotos[
+                            below->state * this->_nonterminalCount + p.lhs - terminals
+                        ];
+
+                        if(target < 0)
+                            continue;
+
+                        const std::uint32_t begin = children.empty() ? pos : children.front()->begin;
+                        const std::uint32_t end = children.empty() ? pos : children.back()->end;
+
+                        self(self, push(
+                            target,
+                            derive(act.target, -1, begin, end, std::move(children)),
+                            std::move(base)
+                        ));
+                    }
+                }
+            }
+        };
+
+        for(const auto& top : active)
+            expand(expand, top);
+
+        if(pos == tokens.size())
+            break;
+
+        // Merge stacks with identical states, keeping the most preferred
+        active.clear();
+        std::unordered_map<std::size_t, std::vector<const frame*>> seen;
+
+        for(auto& stack : shifted)
+        {
+            auto& sameHash = seen[stack->hash];
+
+            if(std::any_of(sameHash.begin(), sameHash.end(), [&](const frame* other) noexcept
+            {
+                return equivalent(stack.get(), other);
+            }))
+                continue;
+
+            sameHash.push_back(stack.get());
+            active.push_back(std::move(stack));
+
+            if(active.size() == maxStacks)
+                break;
+        }
+
+        if(active.empty())
+            return std::nullopt;
+    }
+
+    if(not accepted)
+        return std::nullopt;
+
+    const auto at = [&](const std::uint32_t i) noexcept
+    {
+        return tokens.cbegin() + i;
+    };
+
+    // Builds the AST exactly as the matching combinator would have
+    const auto build = [&](const auto& self, const derivation& d) noexcept -> parse::ast
+    {
+        if(d.production < 0)
+        {
+            if(const std::optional<nonterminal> kind = this->_terminals[d.terminal])
+                return parse::ast(*kind, at(d.begin), at(d.end));
+            else
+                return parse::ast(at(d.begin), at(d.end));
+        }
+
+        const production& p = this->_productions[d.production];
+
+        switch(p.action)
+        {
+        case wrap:
+        {
+            parse::ast child = self(self, *d.children[0]);
+
+            if(child.name.has_value())
+                return parse::ast(p.name, child.begin, child.end, {std::move(child)});
+
+            child.name = p.name;
+            return child;
+        }
+
+        case pass:
+            return self(self, *d.children[0]);
+
+        case empty:
+            return parse::ast(at(d.begin));
+
+        case sequence:
+        {
+            parse::ast output(at(d.begin), at(d.end));
+
+            for(const auto& c : d.children)
+            {
+                parse::ast child = self(self, *c);
+
+                if(child.name.has_value())
+                    output.branches.push_back(std::move(child));
+                else
+                    output.branches.insert(
+                        output.branches.end(),
+                        std::make_move_iterator(child.branches.begin()),
+                        std::make_move_iterator(child.branches.end())
+                    );
+            }
+
+            return output;
+        }
+
+        case first:
+        case next:
+        default:
+        {
+            // Walk down the left spine instead of recursing once per repeat
+            std::vector<const derivation*> repeats;
+            const derivation* spine = &d;
+
+            while(this->_productions[spine->production].action == next)
+            {
+                repeats.push_back(spine->children.back().get());
+                spine = spine->children[0].get();
+            }
+
+            repeats.push_back(spine->children[0].get());
+
+            parse::ast output(at(d.begin), at(d.end));
+
+            for(auto repeat = repeats.rbegin(); repeat != repeats.rend(); ++repeat)
+            {
+                parse::ast child = self(self, **repeat);
+
+                if(child.name.has_value())
+                    output.branches.push_back(std::move(child));
+            }
+
+            return output;
+        }
+        }
+    };
+
+    return build(build, *accepted);
+}
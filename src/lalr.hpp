@@ -0,0 +1,186 @@
+/**
+ * @file lalr.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Table-driven LALR(1) parser with GLR fallback, generated from the combinator grammar in parse.cpp.
+ * @date 2022-08-29
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "parse.hpp"
+
+namespace burbank::lalr
+{
+    /**
+     * @brief How the semantic value of a production is built. Each one mirrors the AST built by one of the combinators in parse.cpp.
+     */
+    enum reduction
+    {
+        /**
+         * @brief `ref`: names the child, or wraps it if it is already named.
+         */
+        wrap,
+
+        /**
+         * @brief `oneOf` and a successful `opt`: the child itself.
+         */
+        pass,
+
+        /**
+         * @brief An `opt` that did not match: an empty AST at the current position.
+         */
+        empty,
+
+        /**
+         * @brief `list`: keeps named children and splices the branches of unnamed ones.
+         */
+        sequence,
+
+        /**
+         * @brief The first item of a `rep` or `csl`.
+         */
+        first,
+
+        /**
+         * @brief Every following item of a `rep` or `csl`.
+         */
+        next
+    };
+
+    /**
+     * @brief A BNF production lowered from the combinator grammar.
+     */
+    struct production
+    {
+        int lhs;
+        std::vector<int> rhs;
+        reduction action;
+
+        /**
+         * @brief The nonterminal that a `wrap` production names its child with.
+         */
+        nonterminal name;
+    };
+
+    /**
+     * @brief An entry in the action table.
+     */
+    struct action
+    {
+        enum : std::uint8_t
+        {
+            shift,
+            reduce,
+            accept
+        } type;
+
+        /**
+         * @brief The state to go to for `shift`, or the production to reduce by for `reduce`.
+         */
+        std::uint32_t target;
+    };
+
+    /**
+     * @brief LALR(1) tables for one start symbol.
+     *
+     * Deterministic regions of the grammar are parsed with a single stack in linear time. Where the tables have conflicts (typedef names against identifiers, casts against parenthesized expressions, dangling `else`, ...) the parser forks and continues with every alternative, GLR-style. Stacks that reach the same LR state sequence are merged, preferring shifts over reductions and earlier alternatives over later ones so that the result agrees with the ordered choice of the combinator parser.
+     */
+    class table
+    {
+    private:
+        std::vector<production> _productions;
+
+        /**
+         * @brief Terminals for each string literal in the grammar.
+         */
+        std::map<std::string, int, std::less<>> _literals;
+
+        /**
+         * @brief Terminals for each kind of lexical token in the grammar.
+         */
+        std::map<nonterminal, int> _kinds;
+
+        /**
+         * @brief For each terminal, the token kind it stands for, or `std::nullopt` for string literals.
+         */
+        std::vector<std::optional<nonterminal>> _terminals;
+
+        /**
+         * @brief Number of nonterminal symbols. Nonterminal `n` has the symbol `_terminals.size() + n`.
+         */
+        int _nonterminalCount = 0;
+
+        /**
+         * @brief `_actions[state * _terminals.size() + terminal]` is a range of `_actionList`, shifts first.
+         */
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> _actions;
+        std::vector<action> _actionList;
+
+        /**
+         * @brief `_gotos[state * _nonterminalCount + nonterminal]`, or -1.
+         */
+        std::vector<std::int32_t> _gotos;
+
+        std::size_t _states = 0;
+        std::size_t _conflicts = 0;
+
+        std::map<const parse::abstractSyntax*, int> _lowered;
+        std::map<nonterminal, int> _references;
+
+        int terminal(std::optional<nonterminal> kind, const std::string& text);
+        int symbol(void);
+        int reference(nonterminal, const std::map<nonterminal, parse::abstractSyntax*>&);
+        int lower(const parse::abstractSyntax*, const std::map<nonterminal, parse::abstractSyntax*>&);
+        void build(void);
+
+    public:
+        /**
+         * @brief Generates the tables for parsing `start` with the given grammar.
+         */
+        explicit table(
+            const nonterminal start = translationUnit,
+            const std::map<nonterminal, parse::abstractSyntax*>& rules = parse::nonterminals
+        );
+
+        /**
+         * @brief Parses all of `tokens`. Returns the same AST as `parse::nonterminals[start]->match(tokens, tokens.cbegin())` when the input is unambiguous, or `std::nullopt` if the tokens are not a complete `start`.
+         *
+         * @param maxStacks The most GLR stacks kept alive at once. The least preferred stacks are dropped beyond this, which bounds the worst case at the cost of completeness.
+         */
+        std::optional<parse::ast> match(
+            const std::vector<lexer::token>& tokens,
+            const std::size_t maxStacks = 64
+        ) const noexcept;
+
+        /**
+         * @brief The number of LALR(1) states.
+         */
+        inline std::size_t states(void) const noexcept
+        {
+            return this->_states;
+        }
+
+        /**
+         * @brief The number of (state, terminal) pairs with more than one action, i.e. where the parser forks.
+         */
+        inline std::size_t conflicts(void) const noexcept
+        {
+            return this->_conflicts;
+        }
+
+        /**
+         * @brief The BNF grammar the tables were built from. Production 0 is the augmented start production.
+         */
+        inline const std::vector<production>& productions(void) const noexcept
+        {
+            return this->_productions;
+        }
+    };
+}
@@ -0,0 +1,61 @@
+/**
+ * @file lazy.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief On-demand parsing of function bodies skipped with `context::lazyBodies`.
+ * @date 2022-09-01
+ */
+
+#include "lazy.hpp"
+
+#include <algorithm>
+
+using namespace burbank;
+using namespace burbank::parse;
+
+bodies::bodies(const std::vector<lexer::token>& tokens, const context& ctx)
+:
+    _tokens(tokens),
+    _typedefs(ctx.typedefNames)
+{
+    auto skipped = ctx.skipped;
+
+    // A body can be skipped more than once if the parser backtracks over it
+    std::sort(skipped.begin(), skipped.end());
+    skipped.erase(std::unique(skipped.begin(), skipped.end()), skipped.end());
+
+    for(const auto begin : skipped)
+    {
+        this->_bodies.push_back(std::make_unique<body>());
+        this->_bodies.back()->begin = begin;
+    }
+}
+
+const ast& bodies::get(const ast& node) const noexcept
+{
+    static const ref compoundStatementRef(compoundStatement);
+
+    const auto found = std::lower_bound(
+        this->_bodies.begin(),
+        this->_bodies.end(),
+        node.begin,
+        [](const std::unique_ptr<body>& b, const auto pos) noexcept
+        {
+            return b->begin < pos;
+        }
+    );
+
+    if(found == this->_bodies.end() or (*found)->begin != node.begin)
+        return node;
+
+    body& b = **found;
+
+    std::call_once(b.once, [&]
+    {
+        context ctx;
+        ctx.outer = &this->_typedefs;
+
+        b.tree = compoundStatementRef.match(this->_tokens, b.begin, ctx);
+    });
+
+    return b.tree.has_value() ? *b.tree : node;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file lazy.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief On-demand parsing of function bodies skipped with `context::lazyBodies`.
+ * @date 2022-09-01
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "parse.hpp"
+
+namespace burbank::parse
+{
+    /**
+     * @brief The function bodies skipped by a lazy parse, each parsed the first time it is asked for.
+     *
+     * Safe to use from several threads at once; every body is parsed at most once.
+     */
+    class bodies
+    {
+    private:
+        struct body
+        {
+            std::vector<lexer::token>::const_iterator begin;
+            std::once_flag once;
+            std::optional<ast> tree;
+        };
+
+        const std::vector<lexer::token>& _tokens;
+
+        /**
+         * @brief The file-scope typedef names, which the bodies can refer to.
+         */
+        const typedefs _typedefs;
+
+        /**
+         * @brief Sorted by `begin`.
+         */
+        std::vector<std::unique_ptr<body>> _bodies;
+
+    public:
+        /**
+         * @brief Collects the bodies skipped while parsing `tokens` with `ctx`. `tokens` must outlive this object.
+         */
+        bodies(const std::vector<lexer::token>& tokens, const context& ctx);
+
+        /**
+         * @brief The fully parsed version of a function body.
+         *
+         * @param node A `compoundStatement` from the lazily parsed AST.
+         *
+         * @return The parsed body, or `node` itself if it was not skipped or does not parse.
+         */
+        const ast& get(const ast& node) const noexcept;
+
+        /**
+         * @brief The number of skipped bodies.
+         */
+        inline std::size_t size(void) const noexcept
+        {
+            return this->_bodies.size();
+        }
+    };
+}
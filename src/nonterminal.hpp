@@ -194,5 +194,8 @@ namespace burbank
         translationUnit,
         externalDeclaration,
         functionDefinition,
+
+        /* Error recovery */
+        error,
     };
 }
\ No newline at end of file
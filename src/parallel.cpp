@@ -0,0 +1,148 @@
+/**
+ * @file parallel.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Parses the top-level declarations of a translation unit concurrently.
+ * @date 2022-08-30
+ */
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+using namespace burbank;
+using namespace burbank::parse;
+
+std::vector<std::vector<lexer::token>::const_iterator> parse::split(const std::vector<lexer::token>& tokens) noexcept
+{
+    std::vector<std::vector<lexer::token>::const_iterator> output;
+    std::size_t depth = 0;
+    bool inBody = false;
+
+    if(tokens.empty())
+        return output;
+
+    output.push_back(tokens.cbegin());
+
+    for(auto pos = tokens.cbegin(); pos != tokens.cend(); ++pos)
+    {
+        // Only punctuators can be brackets or semicolons
+        if(pos->name != punctuator or pos->end - pos->begin != 1)
+            continue;
+
+        switch(*pos->begin)
+        {
+        case '{':
+            // A function body is the only top-level `{` that follows a `)`
+            if(depth == 0)
+                inBody = pos != tokens.cbegin()
+                    and std::prev(pos)->end - std::prev(pos)->begin == 1
+                    and *std::prev(pos)->begin == ')';
+
+            [[fallthrough]];
+        case '(':
+        case '[':
+            ++depth;
+            break;
+
+        case '}':
+            if(depth > 0 and --depth == 0 and inBody)
+            {
+                inBody = false;
+                output.push_back(std::next(pos));
+            }
+
+            break;
+
+        case ')':
+        case ']':
+            // Unbalanced closing brackets are left for the parser to reject
+            if(depth > 0)
+                --depth;
+
+            break;
+
+        case ';':
+            if(depth == 0)
+                output.push_back(std::next(pos));
+
+            break;
+        }
+    }
+
+    // The last split point is the end of the input, which does not begin a declaration
+    if(output.back() == tokens.cend())
+        output.pop_back();
+
+    return output;
+}
+
+std::optional<ast> parse::parallel(const std::vector<lexer::token>& tokens, pool& workers) noexcept
+{
+    static const ref externalDeclarationRef(externalDeclaration);
+
+    const auto splits = parse::split(tokens);
+    std::vector<std::optional<ast>> results(splits.size());
+    std::vector<std::size_t> rest;
+
+    // Declarations after a typedef depend on it, so typedefs are parsed first, in order, to build the file scope
+    context fileScope;
+
+    for(std::size_t i = 0; i < splits.size(); ++i)
+    {
+        const auto end = i + 1 < splits.size() ? splits[i + 1] : tokens.cend();
+
+        const bool hasTypedef = std::any_of(splits[i], end, [](const lexer::token& t) noexcept
+        {
+            return std::string_view(t.begin, t.end) == "typedef";
+        });
+
+        if(hasTypedef)
+            results[i] = externalDeclarationRef.match(tokens, splits[i], fileScope);
+        else
+            rest.push_back(i);
+    }
+
+    workers.run(rest.size(), [&](const std::size_t i, std::size_t)
+    {
+        context ctx;
+        ctx.outer = &fileScope.typedefNames;
+
+        results[rest[i]] = externalDeclarationRef.match(tokens, splits[rest[i]], ctx);
+    });
+
+    /*
+    Mirror `rep` in parse.cpp. Matching is a pure function of the position and the typedefs declared before it, so a result computed in parallel is exactly what the sequential parse would have found there; positions that are not split points are parsed now.
+    */
+    context ctx;
+    ctx.outer = &fileScope.typedefNames;
+
+    auto pos = tokens.cbegin();
+    ast output(pos);
+    std::optional<ast> result;
+    auto next = splits.cbegin();
+
+    if(pos == tokens.cend())
+        return std::nullopt;
+
+    while(output.end != tokens.cend())
+    {
+        next = std::lower_bound(next, splits.cend(), pos);
+
+        if(next != splits.cend() and *next == pos)
+            result = std::move(results[next - splits.cbegin()]);
+        else
+            result = externalDeclarationRef.match(tokens, pos, ctx);
+
+        if(not result.has_value())
+            break;
+
+        output.end = pos = result->end;
+        output.branches.push_back(std::move(*result));
+    }
+
+    if(output.begin == output.end)
+        return std::nullopt;
+    else
+        return output;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file parallel.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Parses the top-level declarations of a translation unit concurrently.
+ * @date 2022-08-30
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "parse.hpp"
+#include "pool.hpp"
+
+namespace burbank::parse
+{
+    /**
+     * @brief Finds where each top-level declaration begins, in one pass over the tokens.
+     *
+     * A declaration ends after a `;` outside of any brackets, or after the `}` of a function body, i.e. a `{` outside of any brackets that directly follows a `)`. Old-style (K&R) parameter declarations are not recognized and simply produce extra split points.
+     *
+     * @return The beginning of every top-level declaration, in order, starting with `tokens.cbegin()`.
+     */
+    std::vector<std::vector<lexer::token>::const_iterator> split(const std::vector<lexer::token>& tokens) noexcept;
+
+    /**
+     * @brief Parses a translation unit by matching each of its top-level declarations on `workers`, then assembling them in source order.
+     *
+     * Declarations containing `typedef` are parsed first and in order, since the declarations after them depend on the typedef names they declare.
+     *
+     * The result is always identical to `nonterminals[translationUnit]->match(tokens, tokens.cbegin())`; wherever the split points do not line up with what the sequential parse would do, that part of the input is parsed again sequentially.
+     */
+    std::optional<ast> parallel(const std::vector<lexer::token>& tokens, pool& workers) noexcept;
+}
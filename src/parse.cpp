@@ -8,6 +8,8 @@
 #include "parse.hpp"
 #include "nonterminal.hpp"
 
+#include <string_view>
+
 using namespace burbank;
 using namespace burbank::parse;
 
@@ -21,6 +23,42 @@ using namespace burbank::parse;
         }))) \
     })}
 
+/*
+Suffixes of a `directAbstractDeclarator`. The rule is written with these repeated after the first part, rather than left-recursively as in the reference grammar, which would recurse forever.
+*/
+#define ABSTRACT_ARRAY_SUFFIX \
+    new list({ \
+        new lit("["), \
+        new oneOf({ \
+            new list({ \
+                new opt(new ref(typeQualifierList)), \
+                new opt(new ref(assignmentExpression)) \
+            }), \
+            new list({ \
+                new ref(storageClassSpecifierStatic), \
+                new opt(new ref(typeQualifierList)), \
+                new ref(assignmentExpression) \
+            }), \
+            new list({ \
+                new ref(typeQualifierList), \
+                new ref(storageClassSpecifierStatic), \
+                new ref(assignmentExpression) \
+            }), \
+            new list({ \
+                new opt(new ref(typeQualifierList)), \
+                new ref(starModifier) \
+            }) \
+        }), \
+        new lit("]") \
+    })
+
+#define ABSTRACT_FUNCTION_SUFFIX \
+    new list({ \
+        new lit("("), \
+        new opt(new ref(parameterTypeList)), \
+        new lit(")") \
+    })
+
 std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
 
     {operatorUnaryPositive, new lit("+")},
@@ -214,7 +252,7 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
 
     {primaryExpression,
     new oneOf({
-        new token(identifier),
+        new typedefToken(false),
         new token(constant),
         new token(stringLiteral),
         new list({
@@ -454,14 +492,14 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
     new ref(conditionalExpression)},
 
     {declaration,
-    new oneOf({
+    new declare(new oneOf({
         new list({
             new ref(declarationSpecifiers),
             new opt(new ref(initDeclaratorList)),
             new lit(";")
         }),
         new ref(staticAssertDeclaration)
-    })},
+    }))},
 
     {declarationSpecifiers,
     new rep(
@@ -506,7 +544,8 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
         new ref(typeSpecifierDouble),
         new ref(typeSpecifierSigned),
         new ref(typeSpecifierUnsigned),
-        new ref(typeSpecifierBool)
+        new ref(typeSpecifierBool),
+        new ref(typedefName)
     })},
 
     {structOrUnionSpecifier,
@@ -715,47 +754,24 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
     })},
 
     {directAbstractDeclarator,
-    new oneOf({
-        new list({
-            new lit("("),
-            new ref(abstractDeclarator),
-            new lit(")")
-        }),
-        new list({
-            new ref(directAbstractDeclarator),
-            new lit("["),
-            new oneOf({
-                new list({
-                    new opt(new ref(typeQualifierList)),
-                    new opt(new ref(assignmentExpression))
-                }),
-                new list({
-                    new ref(storageClassSpecifierStatic),
-                    new opt(new ref(typeQualifierList)),
-                    new ref(assignmentExpression)
-                }),
-                new list({
-                    new ref(typeQualifierList),
-                    new ref(storageClassSpecifierStatic),
-                    new ref(assignmentExpression),
-                }),
-                new list({
-                    new opt(new ref(typeQualifierList)),
-                    new ref(starModifier),
-                })
+    new list({
+        new oneOf({
+            new list({
+                new lit("("),
+                new ref(abstractDeclarator),
+                new lit(")")
             }),
-            new lit("]")
+            ABSTRACT_ARRAY_SUFFIX,
+            ABSTRACT_FUNCTION_SUFFIX
         }),
-        new list({
-            new opt(new ref(directAbstractDeclarator)),
-            new lit("("),
-            new opt(new ref(parameterTypeList)),
-            new lit(")")
-        })
+        new opt(new rep(new oneOf({
+            ABSTRACT_ARRAY_SUFFIX,
+            ABSTRACT_FUNCTION_SUFFIX
+        })))
     })},
 
     {typedefName,
-    new token(identifier)},
+    new typedefToken(true)},
 
     {initializer,
     new oneOf({
@@ -823,18 +839,18 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
     })},
 
     {compoundStatement,
-    new list({
+    new scope(new list({
         new lit("{"),
         new opt(new ref(declarationList)),
         new opt(new ref(statementList)),
         new lit("}")
-    })},
+    }))},
 
     {declarationList,
     new rep(new ref(declaration))},
 
     {statementList,
-    new rep(new ref(statement))},
+    new rep(new recover(new ref(statement)))},
 
     {expressionStatement,
     new list({
@@ -843,7 +859,7 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
     })},
 
     {translationUnit,
-    new rep(new ref(externalDeclaration))},
+    new rep(new recover(new ref(externalDeclaration)))},
 
     {externalDeclaration,
     new oneOf({
@@ -856,7 +872,7 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
         new opt(new ref(declarationSpecifiers)),
         new ref(declarator),
         new opt(new ref(declarationList)),
-        new ref(compoundStatement)
+        new lazy(compoundStatement)
     })}
 };
 
@@ -866,7 +882,8 @@ std::map<nonterminal, parse::abstractSyntax*> burbank::parse::nonterminals = {
 #define MATCH(NAME) \
     std::optional<ast> NAME::match( \
         const std::vector<lexer::token>& tokens, \
-        std::vector<lexer::token>::const_iterator pos \
+        std::vector<lexer::token>::const_iterator pos, \
+        context& ctx \
     ) const noexcept
 
 DESTROY(abstractSyntax)
@@ -880,7 +897,10 @@ MATCH(lit)
     if(pos == tokens.cend()
         or std::string(pos->begin, pos->end) != this->data
     )
+    {
+        ctx.fail(pos, this);
         return std::nullopt;
+    }
     else
         return ast(pos, pos + 1);
 }
@@ -894,7 +914,7 @@ MATCH(ref)
     if(nonterminals.contains(this->data))
     {
         // Get its syntax, return the result of matching it
-        std::optional<ast> result = nonterminals[this->data]->match(tokens, pos);
+        std::optional<ast> result = nonterminals[this->data]->match(tokens, pos, ctx);
 
         if(result.has_value())
         {
@@ -927,7 +947,10 @@ DESTROY(token)
 MATCH(token)
 {
     if(pos == tokens.cend() or pos->name != this->data)
+    {
+        ctx.fail(pos, this);
         return std::nullopt;
+    }
     else
         return ast(pos->name, pos, std::next(pos));
 }
@@ -939,7 +962,7 @@ DESTROY(opt)
 
 MATCH(opt)
 {
-    std::optional<ast> result = this->data->match(tokens, pos);
+    std::optional<ast> result = this->data->match(tokens, pos, ctx);
 
     // Does the rule match? Great! Return the result as normal.
     if(result.has_value())
@@ -966,7 +989,7 @@ MATCH(rep)
     while(output.end != tokens.cend())
     {
         // Try to match the repeated rule
-        result = this->data->match(tokens, pos);
+        result = this->data->match(tokens, pos, ctx);
 
         // No more repeats; we're done
         if(not result.has_value())
@@ -1007,7 +1030,7 @@ MATCH(oneOf)
     // Go through all of the alternatives
     for(const auto syntax : this->data)
     {
-        result = syntax->match(tokens, pos);
+        result = syntax->match(tokens, pos, ctx);
 
         // As soon as one of them matches, return the AST
         if(result.has_value())
@@ -1029,6 +1052,9 @@ MATCH(list)
     ast output(pos);
     std::optional<ast> result;
 
+    // Declarations from a partial match must not outlive it
+    const std::size_t declared = ctx.typedefNames.size();
+
     if(pos == tokens.cend())
         return std::nullopt;
 
@@ -1036,11 +1062,14 @@ MATCH(list)
     for(const abstractSyntax* syntax : this->data)
     {
         // Try to match the rule
-        result = syntax->match(tokens, pos);
+        result = syntax->match(tokens, pos, ctx);
 
         // Rule didn't match, therefore the whole list does not match
         if(not result.has_value())
+        {
+            ctx.typedefNames.truncate(declared);
             return std::nullopt;
+        }
 
         // Extend the matched text
         output.end = result->end;
@@ -1086,7 +1115,7 @@ MATCH(csl)
             onFirstMatch = false;
         else
         {
-            result = comma->match(tokens, pos);
+            result = comma->match(tokens, pos, ctx);
 
             if(not result.has_value())
                 break;
@@ -1097,7 +1126,7 @@ MATCH(csl)
         }
 
         // Try to match the repeated rule
-        result = this->data->match(tokens, pos);
+        result = this->data->match(tokens, pos, ctx);
 
         // No more repeats; we're done
         if(not result.has_value())
@@ -1121,4 +1150,293 @@ MATCH(csl)
         return std::nullopt;
     else
         return output;
-}
\ No newline at end of file
+}
+
+DESTROY(lazy)
+{} // Intentionally empty
+
+MATCH(lazy)
+{
+    if(not ctx.lazyBodies)
+        return ref(this->data).match(tokens, pos, ctx);
+
+    if(pos == tokens.cend() or std::string_view(pos->begin, pos->end) != "{")
+        return std::nullopt;
+
+    std::size_t depth = 0;
+
+    // Find the matching closing brace
+    for(auto end = pos; end != tokens.cend(); ++end)
+    {
+        const std::string_view text(end->begin, end->end);
+
+        if(text == "{")
+            ++depth;
+        else if(text == "}" and --depth == 0)
+        {
+            ctx.skipped.push_back(pos);
+            return ast(this->data, pos, std::next(end));
+        }
+    }
+
+    // Unbalanced
+    return std::nullopt;
+}
+DESTROY(recover)
+{
+    delete this->data;
+}
+
+MATCH(recover)
+{
+    // Only failures inside this match belong to its error, so set aside the ones from before
+    const auto farthest = ctx.farthest;
+    auto expected = std::move(ctx.expected);
+
+    ctx.farthest.reset();
+    ctx.expected.clear();
+
+    ++ctx.recovering;
+    std::optional<ast> result = this->data->match(tokens, pos, ctx);
+    --ctx.recovering;
+
+    std::optional<diagnostic> error;
+
+    if(not result.has_value() and ctx.recover)
+        error = ctx.error();
+
+    // Merge the failures back in
+    if(farthest.has_value()
+        and (not ctx.farthest.has_value() or *farthest > *ctx.farthest)
+    )
+    {
+        ctx.farthest = farthest;
+        ctx.expected = std::move(expected);
+    }
+    else if(farthest == ctx.farthest)
+    {
+        for(const abstractSyntax* syntax : expected)
+            ctx.fail(*farthest, syntax);
+    }
+
+    if(result.has_value() or not ctx.recover or pos == tokens.cend())
+        return result;
+
+    // A closing brace ends the enclosing block, unless there is no enclosing block
+    if(std::string_view(pos->begin, pos->end) == "}" and ctx.recovering != 0)
+        return std::nullopt;
+
+    std::size_t depth = 0;
+    auto end = pos;
+
+    // Skip to the end of the statement or declaration
+    while(end != tokens.cend())
+    {
+        const std::string_view text(end->begin, end->end);
+
+        if(text == "{" or text == "(" or text == "[")
+            ++depth;
+        else if(text == ")" or text == "]")
+        {
+            if(depth != 0)
+                --depth;
+        }
+        else if(text == "}")
+        {
+            // A stray closing brace at the top level is skipped on its own
+            if(depth == 0)
+            {
+                if(end == pos)
+                    ++end;
+
+                break;
+            }
+            else if(--depth == 0)
+            {
+                ++end;
+                break;
+            }
+        }
+        else if(text == ";" and depth == 0)
+        {
+            ++end;
+            break;
+        }
+
+        ++end;
+    }
+
+    ctx.errors.push_back(error.value_or(diagnostic {pos, {}}));
+    return ast(nonterminal::error, pos, end);
+}
+
+DESTROY(typedefToken)
+{} // Intentionally empty
+
+MATCH(typedefToken)
+{
+    if(pos == tokens.cend()
+        or pos->name != identifier
+        or ctx.isTypedefName(pos) != this->data
+    )
+    {
+        ctx.fail(pos, this);
+        return std::nullopt;
+    }
+
+    // A typedef name is not a type specifier if it follows another one, as in `int T;`, where `T` is being redeclared
+    if(this->data and pos != tokens.cbegin())
+    {
+        const auto previous = std::prev(pos);
+
+        if(previous->name == identifier)
+            return std::nullopt;
+
+        static const std::string_view typeKeywords[] = {
+            "void", "char", "short", "int", "long", "float", "double", "signed", "unsigned", "_Bool", "_Complex"
+        };
+
+        const std::string_view text(previous->begin, previous->end);
+
+        if(std::find(std::begin(typeKeywords), std::end(typeKeywords), text) != std::end(typeKeywords))
+            return std::nullopt;
+    }
+
+    return ast(identifier, pos, std::next(pos));
+}
+
+DESTROY(declare)
+{
+    delete this->data;
+}
+
+MATCH(declare)
+{
+    std::optional<ast> result = this->data->match(tokens, pos, ctx);
+
+    if(result.has_value())
+        ctx.declare(*result);
+
+    return result;
+}
+
+DESTROY(scope)
+{
+    delete this->data;
+}
+
+MATCH(scope)
+{
+    const std::size_t declared = ctx.typedefNames.size();
+    std::optional<ast> result = this->data->match(tokens, pos, ctx);
+
+    ctx.typedefNames.truncate(declared);
+    return result;
+}
+
+/**
+ * @brief The identifier declared by a `declarator`, if any.
+ */
+static const ast* declaredName(const ast& outermost) noexcept
+{
+    const ast* node = &outermost;
+
+    // declarator -> directDeclarator -> (identifier | declarator)
+    while(node->name == nonterminal::declarator)
+    {
+        const auto direct = std::find_if(node->branches.begin(), node->branches.end(), [](const ast& b) noexcept
+        {
+            return b.name == directDeclarator;
+        });
+
+        if(direct == node->branches.end() or direct->branches.empty())
+            return nullptr;
+
+        node = &direct->branches.front();
+    }
+
+    return node->name == identifier ? node : nullptr;
+}
+
+void context::declare(const ast& declaration)
+{
+    bool isTypedef = false;
+
+    for(const ast& branch : declaration.branches)
+    {
+        if(branch.name == declarationSpecifiers)
+        {
+            for(const ast& specifier : branch.branches)
+            {
+                if(specifier.name == storageClassSpecifier
+                    and not specifier.branches.empty()
+                    and specifier.branches.front().name == storageClassSpecifierTypedef
+                )
+                    isTypedef = true;
+            }
+        }
+        else if(branch.name == initDeclaratorList)
+        {
+            for(const ast& item : branch.branches)
+            {
+                if(item.branches.empty())
+                    continue;
+
+                const ast* name = declaredName(item.branches.front());
+
+                // Ordinary names only matter when they hide a typedef name
+                if(name != nullptr and (isTypedef or this->isTypedefName(name->begin)))
+                    this->typedefNames.add(name->begin, isTypedef);
+            }
+        }
+    }
+}
+
+/**
+ * @brief How a literal or token is shown in a `diagnostic`.
+ */
+static std::string describe(const abstractSyntax* syntax) noexcept
+{
+    if(const auto* l = dynamic_cast<const lit*>(syntax))
+        return '"' + l->data + '"';
+    else if(const auto* t = dynamic_cast<const typedefToken*>(syntax))
+        return t->data ? "typedef name" : "identifier";
+    else if(const auto* t = dynamic_cast<const token*>(syntax))
+    {
+        switch(t->data)
+        {
+            case identifier:
+                return "identifier";
+            case constant:
+                return "constant";
+            case stringLiteral:
+                return "string literal";
+            case keyword:
+                return "keyword";
+            case punctuator:
+                return "punctuator";
+            default:
+                return "token";
+        }
+    }
+    else
+        return "?";
+}
+
+std::optional<diagnostic> context::error(void) const noexcept
+{
+    if(not this->farthest.has_value())
+        return std::nullopt;
+
+    diagnostic output {*this->farthest, {}};
+
+    for(const abstractSyntax* syntax : this->expected)
+    {
+        std::string text = describe(syntax);
+
+        if(std::find(output.expected.begin(), output.expected.end(), text) == output.expected.end())
+            output.expected.push_back(std::move(text));
+    }
+
+    return output;
+}
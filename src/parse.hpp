@@ -9,9 +9,12 @@
 
 #include "lexer.hpp"
 
+#include <algorithm>
 #include <optional>
 #include <variant>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
@@ -79,6 +82,223 @@ namespace burbank::parse
         bool persist = false;
     };
 
+    struct abstractSyntax;
+
+    /**
+     * @brief Names declared by typedefs, and the ordinary declarations that hide them in inner scopes.
+     *
+     * Declarations are kept as a log so that the table can be cut back to an earlier length when the parser backtracks or leaves a block.
+     */
+    class typedefs
+    {
+    private:
+        struct entry
+        {
+            std::string_view name;
+
+            /**
+             * @brief The declarator's identifier; the declaration is in effect from here on.
+             */
+            std::vector<lexer::token>::const_iterator where;
+
+            bool isTypedef;
+
+            /**
+             * @brief The previous declaration of the same name, if any.
+             */
+            std::size_t previous;
+        };
+
+        static constexpr std::size_t none = -1;
+
+        std::vector<entry> _log;
+
+        /**
+         * @brief The last declaration of every name in the log.
+         */
+        std::unordered_map<std::string_view, std::size_t> _latest;
+
+    public:
+        /**
+         * @brief Whether `name` has been declared at all.
+         */
+        inline bool declares(const std::string_view name) const noexcept
+        {
+            return this->_latest.contains(name);
+        }
+
+        /**
+         * @brief Whether `name` is a typedef name at `pos`, counting only declarations before `pos`.
+         */
+        inline bool contains(
+            const std::string_view name,
+            const std::vector<lexer::token>::const_iterator pos
+        ) const noexcept
+        {
+            const auto found = this->_latest.find(name);
+
+            if(found == this->_latest.end())
+                return false;
+
+            std::size_t i = found->second;
+
+            while(i != none and this->_log[i].where >= pos)
+                i = this->_log[i].previous;
+
+            return i != none and this->_log[i].isTypedef;
+        }
+
+        /**
+         * @brief Adds a declaration of the identifier at `where`.
+         */
+        inline void add(const std::vector<lexer::token>::const_iterator where, const bool isTypedef)
+        {
+            const std::string_view name(where->begin, where->end);
+            const auto [found, inserted] = this->_latest.try_emplace(name, this->_log.size());
+
+            this->_log.push_back({name, where, isTypedef, inserted ? none : found->second});
+            found->second = this->_log.size() - 1;
+        }
+
+        /**
+         * @brief The number of declarations in the log.
+         */
+        inline std::size_t size(void) const noexcept
+        {
+            return this->_log.size();
+        }
+
+        /**
+         * @brief Forgets every declaration after the first `size`.
+         */
+        inline void truncate(const std::size_t size) noexcept
+        {
+            while(this->_log.size() > size)
+            {
+                const entry& last = this->_log.back();
+
+                if(last.previous == none)
+                    this->_latest.erase(last.name);
+                else
+                    this->_latest[last.name] = last.previous;
+
+                this->_log.pop_back();
+            }
+        }
+    };
+
+    /**
+     * @brief A syntax error.
+     */
+    struct diagnostic
+    {
+        /**
+         * @brief The token that could not be matched; the end of the tokens if more were expected.
+         */
+        std::vector<lexer::token>::const_iterator where;
+
+        /**
+         * @brief What would have been accepted there, e.g. `";"` or `identifier`.
+         */
+        std::vector<std::string> expected;
+    };
+
+    /**
+     * @brief State and options for a single parse. Pass the same context to every `match` call that belongs to the same parse.
+     */
+    struct context
+    {
+        /**
+         * @brief Whether to skip the bodies of function definitions by matching braces instead of parsing them.
+         *
+         * Skipped bodies appear in the AST as `compoundStatement`s with no branches and are listed in `skipped`. @see parse::bodies
+         */
+        bool lazyBodies = false;
+
+        /**
+         * @brief The opening brace of every function body skipped so far.
+         */
+        std::vector<std::vector<lexer::token>::const_iterator> skipped;
+
+        /**
+         * @brief Whether to skip over statements and top-level declarations that do not parse, producing `error` nodes in their place and recording them in `errors`.
+         */
+        bool recover = false;
+
+        /**
+         * @brief Syntax errors skipped over because of `recover`, in order.
+         */
+        std::vector<diagnostic> errors;
+
+        /**
+         * @brief The farthest position at which a literal or token failed to match.
+         */
+        std::optional<std::vector<lexer::token>::const_iterator> farthest;
+
+        /**
+         * @brief The literals and tokens that failed to match at `farthest`.
+         */
+        std::vector<const abstractSyntax*> expected;
+
+        /**
+         * @brief How many `recover`s are currently being matched; only the outermost one may skip a stray `}`.
+         */
+        std::size_t recovering = 0;
+
+        /**
+         * @brief The typedef names declared so far in the scopes being parsed.
+         */
+        typedefs typedefNames;
+
+        /**
+         * @brief Typedef names declared outside the code being parsed, e.g. at file scope when declarations are parsed separately. Only those declared before the position being parsed count.
+         */
+        const typedefs* outer = nullptr;
+
+        /**
+         * @brief Whether the identifier at `pos` is a typedef name.
+         */
+        inline bool isTypedefName(const std::vector<lexer::token>::const_iterator pos) const noexcept
+        {
+            const std::string_view name(pos->begin, pos->end);
+
+            if(this->typedefNames.declares(name))
+                return this->typedefNames.contains(name, pos);
+            else
+                return this->outer != nullptr and this->outer->contains(name, pos);
+        }
+
+        /**
+         * @brief Adds the names declared by a `declaration` to `typedefNames`: every name if it is a typedef, otherwise only the names that hide a typedef name.
+         */
+        void declare(const ast& declaration);
+
+        /**
+         * @brief Records that `syntax` did not match at `pos`.
+         */
+        inline void fail(
+            const std::vector<lexer::token>::const_iterator pos,
+            const abstractSyntax* syntax
+        ) noexcept
+        {
+            if(not this->farthest.has_value() or pos > *this->farthest)
+            {
+                this->farthest = pos;
+                this->expected.clear();
+            }
+
+            if(pos == *this->farthest
+                and std::find(this->expected.begin(), this->expected.end(), syntax) == this->expected.end()
+            )
+                this->expected.push_back(syntax);
+        }
+
+        /**
+         * @brief The farthest failure so far, which is where the syntax error is if the parse failed or stopped early.
+         */
+        std::optional<diagnostic> error(void) const noexcept;
+    };
+
     /**
      * @brief 
      */
@@ -95,9 +315,22 @@ namespace burbank::parse
          */
         virtual std::optional<ast> match(
             const std::vector<lexer::token>&,
-            std::vector<lexer::token>::const_iterator
+            std::vector<lexer::token>::const_iterator,
+            context&
         ) const noexcept
             = 0;
+
+        /**
+         * @brief Matches with a fresh context and default options.
+         */
+        inline std::optional<ast> match(
+            const std::vector<lexer::token>& tokens,
+            const std::vector<lexer::token>::const_iterator pos
+        ) const noexcept
+        {
+            context ctx;
+            return this->match(tokens, pos, ctx);
+        }
     };
 
     #define SYNTAX_SPECIFIER(NAME, TYPE) \
@@ -110,10 +343,13 @@ namespace burbank::parse
             : \
                 data(data) \
             {} \
+        \
+            using abstractSyntax::match; \
         \
             std::optional<ast> match( \
                 const std::vector<lexer::token>&, \
-                std::vector<lexer::token>::const_iterator \
+                std::vector<lexer::token>::const_iterator, \
+                context& \
             ) const noexcept; \
         \
             ~NAME(void) noexcept; \
@@ -159,6 +395,31 @@ namespace burbank::parse
      */
     SYNTAX_SPECIFIER(csl, abstractSyntax*);
 
+    /**
+     * @brief Matches another nonterminal symbol by its name like `ref`, unless `context::lazyBodies` is set, in which case it only matches braces.
+     */
+    SYNTAX_SPECIFIER(lazy, nonterminal);
+
+    /**
+     * @brief Matches the given syntax. If it does not match and `context::recover` is set, skips to the end of the statement or declaration instead and produces an `error` node.
+     */
+    SYNTAX_SPECIFIER(recover, abstractSyntax*);
+
+    /**
+     * @brief Matches an identifier that is (`true`) or is not (`false`) a typedef name in scope.
+     */
+    SYNTAX_SPECIFIER(typedefToken, bool);
+
+    /**
+     * @brief Matches a declaration and adds the names it declares to `context::typedefNames`.
+     */
+    SYNTAX_SPECIFIER(declare, abstractSyntax*);
+
+    /**
+     * @brief Matches the given syntax; typedef names declared inside it go out of scope at its end.
+     */
+    SYNTAX_SPECIFIER(scope, abstractSyntax*);
+
     /**
      * @brief Nonterminal symbols understood by the parser.
      *
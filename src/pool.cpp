@@ -0,0 +1,137 @@
+/**
+ * @file pool.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A work-stealing thread pool.
+ * @date 2022-08-30
+ */
+
+#include "pool.hpp"
+
+#include <algorithm>
+
+using burbank::pool;
+
+pool::pool(const std::size_t threads /* = std::thread::hardware_concurrency() */)
+{
+    const std::size_t count = std::max<std::size_t>(threads, 1);
+
+    for(std::size_t i = 0; i < count; ++i)
+        this->_queues.push_back(std::make_unique<queue>());
+
+    for(std::size_t i = 0; i < count; ++i)
+        this->_threads.emplace_back(&pool::work, this, i);
+}
+
+pool::~pool(void) noexcept
+{
+    {
+        std::lock_guard guard(this->_lock);
+        this->_stop = true;
+    }
+
+    this->_wake.notify_all();
+
+    for(std::thread& thread : this->_threads)
+        thread.join();
+}
+
+bool pool::take(const std::size_t worker, std::size_t& item) noexcept
+{
+    // Our own queue first, from the front so that neighbouring items stay on one thread
+    {
+        queue& own = *this->_queues[worker];
+        std::lock_guard guard(own.lock);
+
+        if(not own.items.empty())
+        {
+            item = own.items.front();
+            own.items.pop_front();
+            return true;
+        }
+    }
+
+    // Then steal from the back of everyone else's
+    for(std::size_t i = 1; i < this->_queues.size(); ++i)
+    {
+        queue& other = *this->_queues[(worker + i) % this->_queues.size()];
+        std::lock_guard guard(other.lock);
+
+        if(not other.items.empty())
+        {
+            item = other.items.back();
+            other.items.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void pool::work(const std::size_t worker) noexcept
+{
+    std::size_t seen = 0;
+    std::size_t item;
+
+    while(true)
+    {
+        {
+            std::unique_lock guard(this->_lock);
+
+            this->_wake.wait(guard, [&]
+            {
+                return this->_stop or this->_generation != seen;
+            });
+
+            if(this->_stop)
+                return;
+
+            seen = this->_generation;
+        }
+
+        while(this->take(worker, item))
+        {
+            // `_task` was set before the items were queued, and taking an item synchronizes with queuing it
+            (*this->_task)(item, worker);
+
+            std::lock_guard guard(this->_lock);
+
+            if(--this->_remaining == 0)
+                this->_done.notify_all();
+        }
+    }
+}
+
+void pool::run(const std::size_t count, const task& task) noexcept
+{
+    if(count == 0)
+        return;
+
+    {
+        std::lock_guard guard(this->_lock);
+        this->_task = &task;
+        this->_remaining = count;
+    }
+
+    // Deal the items out in contiguous blocks
+    const std::size_t workers = this->_queues.size();
+
+    for(std::size_t w = 0; w < workers; ++w)
+    {
+        queue& q = *this->_queues[w];
+        std::lock_guard guard(q.lock);
+
+        for(std::size_t i = count * w / workers; i < count * (w + 1) / workers; ++i)
+            q.items.push_back(i);
+    }
+
+    std::unique_lock guard(this->_lock);
+    ++this->_generation;
+    this->_wake.notify_all();
+
+    this->_done.wait(guard, [this]
+    {
+        return this->_remaining == 0;
+    });
+
+    this->_task = nullptr;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file pool.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief A work-stealing thread pool.
+ * @date 2022-08-30
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace burbank
+{
+    /**
+     * @brief A fixed set of worker threads, each with its own queue of tasks. Idle workers steal from the back of other workers' queues.
+     */
+    class pool
+    {
+    public:
+        /**
+         * @brief A task: the index of the item to process and the index of the worker running it, which can be used to look up per-thread state.
+         */
+        using task = std::function<void(std::size_t item, std::size_t worker)>;
+
+    private:
+        struct queue
+        {
+            std::mutex lock;
+            std::deque<std::size_t> items;
+        };
+
+        std::vector<std::thread> _threads;
+        std::vector<std::unique_ptr<queue>> _queues;
+
+        std::mutex _lock;
+        std::condition_variable _wake, _done;
+
+        const task* _task = nullptr;
+        std::size_t _generation = 0;
+        std::size_t _remaining = 0;
+        bool _stop = false;
+
+        void work(std::size_t worker) noexcept;
+        bool take(std::size_t worker, std::size_t& item) noexcept;
+
+    public:
+        /**
+         * @brief Starts the workers.
+         *
+         * @param threads Number of workers, at least one.
+         */
+        explicit pool(const std::size_t threads = std::thread::hardware_concurrency());
+
+        /**
+         * @brief Stops the workers once they are idle.
+         */
+        ~pool(void) noexcept;
+
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+
+        /**
+         * @brief Runs `task(i, worker)` for every `i` in `[0, count)` and blocks until all of them are done.
+         */
+        void run(const std::size_t count, const task& task) noexcept;
+
+        /**
+         * @brief The number of workers.
+         */
+        inline std::size_t size(void) const noexcept
+        {
+            return this->_threads.size();
+        }
+    };
+}
@@ -0,0 +1,274 @@
+/**
+ * @file reparse.cpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Incrementally re-parses a translation unit after an edit, reusing every subtree the edit did not touch.
+ * @date 2022-08-31
+ */
+
+#include "reparse.hpp"
+
+#include <algorithm>
+
+using namespace burbank;
+using namespace burbank::parse;
+
+namespace
+{
+    using iterator = std::vector<lexer::token>::const_iterator;
+
+    /**
+     * @brief Moves the token iterators of a tree from the old token stream to the new one.
+     */
+    struct rebase
+    {
+        iterator oldBegin, newBegin;
+        edit change;
+
+        inline std::size_t index(const iterator pos) const noexcept
+        {
+            return pos - this->oldBegin;
+        }
+
+        /**
+         * @brief Where the token at old index `i` is now. Tokens inside the edit are clamped to its beginning; only subtrees that are about to be replaced contain them.
+         */
+        inline iterator first(const std::size_t i) const noexcept
+        {
+            if(i < this->change.begin)
+                return this->newBegin + i;
+            else if(i >= this->change.end)
+                return this->newBegin + i - this->change.end + this->change.begin + this->change.length;
+            else
+                return this->newBegin + this->change.begin;
+        }
+
+        /**
+         * @brief Where the end of a range ending at old index `i` (exclusive) is now.
+         */
+        inline iterator last(const std::size_t i) const noexcept
+        {
+            if(i <= this->change.begin)
+                return this->newBegin + i;
+            else if(i > this->change.end)
+                return this->newBegin + i - this->change.end + this->change.begin + this->change.length;
+            else
+                return this->newBegin + this->change.begin + this->change.length;
+        }
+
+        void operator()(ast& tree) const noexcept
+        {
+            std::vector<ast*> pending {&tree};
+
+            while(not pending.empty())
+            {
+                ast& node = *pending.back();
+                pending.pop_back();
+
+                const bool isEmpty = node.begin == node.end;
+
+                node.begin = this->first(this->index(node.begin));
+                node.end = isEmpty ? node.begin : this->last(this->index(node.end));
+
+                for(ast& branch : node.branches)
+                    pending.push_back(&branch);
+            }
+        }
+    };
+
+    /**
+     * @brief Whether a top-level declaration declares a typedef name.
+     */
+    bool declaresTypedef(const ast& declaration) noexcept
+    {
+        if(declaration.name != externalDeclaration
+            or declaration.branches.empty()
+            or declaration.branches.front().name != nonterminal::declaration
+        )
+            return false;
+
+        context probe;
+        probe.declare(declaration.branches.front());
+
+        return probe.typedefNames.size() != 0;
+    }
+}
+
+std::optional<ast> parse::reparse(
+    ast tree,
+    const std::vector<lexer::token>& oldTokens,
+    const std::vector<lexer::token>& newTokens,
+    const edit& change
+) noexcept
+{
+    static const ref compoundStatementRef(compoundStatement);
+    static const ref externalDeclarationRef(externalDeclaration);
+
+    const rebase move {oldTokens.cbegin(), newTokens.cbegin(), change};
+    const std::ptrdiff_t delta = std::ptrdiff_t(change.length) - std::ptrdiff_t(change.end - change.begin);
+
+    /* Try the innermost block first */
+
+    std::vector<ast*> blocks;
+
+    for(ast* node = &tree; node != nullptr;)
+    {
+        if(node->name == compoundStatement
+            and move.index(node->begin) < change.begin
+            and change.end < move.index(node->end)
+        )
+            blocks.push_back(node);
+
+        // Branches are in order and do not overlap, so only the last one beginning at or before the edit can contain it
+        const auto branch = std::upper_bound(
+            node->branches.begin(),
+            node->branches.end(),
+            change.begin,
+            [&](const std::size_t i, const ast& b) noexcept
+            {
+                return i < move.index(b.begin);
+            }
+        );
+
+        if(branch == node->branches.begin())
+            break;
+
+        ast& candidate = *std::prev(branch);
+
+        if(move.index(candidate.begin) <= change.begin and change.end <= move.index(candidate.end))
+            node = &candidate;
+        else
+            node = nullptr;
+    }
+
+    for(std::size_t k = blocks.size(); k-- > 0;)
+    {
+        ast* const block = blocks[k];
+        const std::size_t begin = move.index(block->begin);
+        const std::size_t end = move.index(block->end) + delta;
+
+        // The typedef names in scope at the block: those at file scope and those declared by the blocks around it. Everything before the block is before the edit, so copies of those declarations can be moved to the new tokens on their own.
+        context ctx;
+
+        const auto add = [&](const ast& declaration)
+        {
+            if(move.index(declaration.end) <= begin)
+            {
+                ast copy = declaration;
+                move(copy);
+                ctx.declare(copy);
+            }
+        };
+
+        for(const ast& d : tree.branches)
+        {
+            if(declaresTypedef(d))
+                add(d.branches.front());
+        }
+
+        for(std::size_t outer = 0; outer < k; ++outer)
+        {
+            for(const ast& list : blocks[outer]->branches)
+            {
+                if(list.name == declarationList)
+                {
+                    for(const ast& d : list.branches)
+                        add(d);
+                }
+            }
+        }
+
+        // In this grammar, nothing that is tried before a block looks past its opening brace, so a block that still ends on the same brace leaves everything around it unchanged
+        std::optional<ast> result = compoundStatementRef.match(newTokens, newTokens.cbegin() + begin, ctx);
+
+        if(result.has_value() and result->end == newTokens.cbegin() + end)
+        {
+            move(tree);
+            *block = std::move(*result);
+            return tree;
+        }
+    }
+
+    /* Otherwise re-parse top-level declarations until the parse lines up with an old one */
+
+    std::vector<ast>& old = tree.branches;
+
+    // The first declaration touching the edit; one that ends right where tokens were inserted is included, since they may extend it
+    const std::size_t first = std::find_if(old.begin(), old.end(), [&](const ast& d) noexcept
+    {
+        return move.index(d.end) >= change.begin;
+    }) - old.begin();
+
+    const std::size_t start = first < old.size()
+        ? move.index(old[first].begin)
+        : std::min(move.index(tree.end), change.begin);
+
+    // Only declarations entirely after the edit can be reused
+    std::size_t reusable = std::find_if(old.begin() + first, old.end(), [&](const ast& d) noexcept
+    {
+        return move.index(d.begin) >= change.end;
+    }) - old.begin();
+
+    // Declarations after a typedef that was added or removed may now parse differently, so none of them are reused
+    bool typedefsChanged = std::any_of(old.begin() + first, old.begin() + reusable, declaresTypedef);
+
+    move(tree);
+
+    if(newTokens.empty())
+        return std::nullopt;
+
+    context ctx;
+
+    for(auto d = old.begin(); d != old.begin() + first; ++d)
+    {
+        if(declaresTypedef(*d))
+            ctx.declare(d->branches.front());
+    }
+
+    const std::size_t declared = ctx.typedefNames.size();
+
+    /* Mirror `rep` in parse.cpp */
+
+    auto pos = newTokens.cbegin() + start;
+    ast output(newTokens.cbegin(), pos);
+    std::optional<ast> result;
+
+    output.branches.insert(
+        output.branches.end(),
+        std::make_move_iterator(old.begin()),
+        std::make_move_iterator(old.begin() + first)
+    );
+
+    while(output.end != newTokens.cend())
+    {
+        while(reusable < old.size() and old[reusable].begin < pos)
+            ++reusable;
+
+        // Back in step with the old parse, which is a pure function of the position from here on
+        if(reusable < old.size() and old[reusable].begin == pos and not typedefsChanged)
+        {
+            output.branches.insert(
+                output.branches.end(),
+                std::make_move_iterator(old.begin() + reusable),
+                std::make_move_iterator(old.end())
+            );
+
+            output.end = tree.end;
+            break;
+        }
+
+        result = externalDeclarationRef.match(newTokens, pos, ctx);
+
+        if(not result.has_value())
+            break;
+
+        typedefsChanged = typedefsChanged or ctx.typedefNames.size() != declared;
+
+        output.end = pos = result->end;
+        output.branches.push_back(std::move(*result));
+    }
+
+    if(output.begin == output.end)
+        return std::nullopt;
+    else
+        return output;
+}
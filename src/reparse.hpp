@@ -0,0 +1,43 @@
+/**
+ * @file reparse.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Incrementally re-parses a translation unit after an edit, reusing every subtree the edit did not touch.
+ * @date 2022-08-31
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "parse.hpp"
+
+namespace burbank::parse
+{
+    /**
+     * @brief A change to a token stream: the tokens `[begin, end)` of the old stream were replaced by `length` tokens, which begin at index `begin` of the new stream.
+     */
+    struct edit
+    {
+        std::size_t begin, end, length;
+    };
+
+    /**
+     * @brief Re-parses a translation unit after an edit.
+     *
+     * The smallest `compoundStatement` whose braces the edit did not touch is re-parsed on its own, as long as it still ends on the same brace. Otherwise the top-level declarations from the one containing the edit are re-parsed until the parse lines up with an old declaration boundary again, after which the old declarations are reused. If a typedef was added or removed, the declarations after it may parse differently, so none of them are reused.
+     *
+     * Reused subtrees are moved out of `tree` and only have their token iterators rebased onto `newTokens`, which is a single pass without any allocation.
+     *
+     * @param tree The result of `nonterminals[translationUnit]->match(oldTokens, oldTokens.cbegin())`.
+     *
+     * @return The same AST as `nonterminals[translationUnit]->match(newTokens, newTokens.cbegin())`.
+     */
+    std::optional<ast> reparse(
+        ast tree,
+        const std::vector<lexer::token>& oldTokens,
+        const std::vector<lexer::token>& newTokens,
+        const edit& change
+    ) noexcept;
+}
@@ -0,0 +1,1135 @@
+/**
+ * @file typed.hpp
+ * @author Weiju Wang (weijuwang@aol.com)
+ * @brief Statically typed parser combinators. The C grammar is written here as nested types so that the compiler can inline whole rule chains instead of going through `parse::abstractSyntax::match`.
+ * @date 2022-08-28
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "parse.hpp"
+
+namespace burbank::typed
+{
+    using parse::ast;
+
+    /**
+     * @brief A string literal that can be used as a template argument.
+     */
+    template<std::size_t N>
+    struct literal
+    {
+        char data[N];
+
+        constexpr literal(const char (&str)[N]) noexcept
+        {
+            std::copy_n(str, N, this->data);
+        }
+
+        /**
+         * @brief The literal without its null terminator.
+         */
+        constexpr std::string_view view(void) const noexcept
+        {
+            return std::string_view(this->data, N - 1);
+        }
+    };
+
+    /**
+     * @brief The syntax of a nonterminal. Specialized once per nonterminal with a member `type`.
+     */
+    template<nonterminal NAME>
+    struct rule;
+
+    #define SYNTAX_MATCH \
+        static std::optional<ast> match( \
+            const std::vector<lexer::token>& tokens, \
+            std::vector<lexer::token>::const_iterator pos \
+        ) noexcept
+
+    /**
+     * @brief Matches a string literal.
+     */
+    template<literal DATA>
+    struct lit
+    {
+        SYNTAX_MATCH
+        {
+            if(pos == tokens.cend()
+                or std::string_view(pos->begin, pos->end) != DATA.view()
+            )
+                return std::nullopt;
+            else
+                return ast(pos, pos + 1);
+        }
+    };
+
+    /**
+     * @brief Matches another nonterminal symbol by its name.
+     */
+    template<nonterminal DATA>
+    struct ref
+    {
+        SYNTAX_MATCH
+        {
+            std::optional<ast> result = rule<DATA>::type::match(tokens, pos);
+
+            if(not result.has_value())
+                return std::nullopt;
+
+            // If the syntax was named, wrap it so that the original name is preserved
+            if(result->name.has_value())
+            {
+                const auto begin = result->begin, end = result->end;
+
+                return ast {
+                    DATA,
+                    begin,
+                    end,
+                    { std::move(*result) }
+                };
+            }
+
+            // Record the name of this AST
+            result->name = DATA;
+            return result;
+        }
+    };
+
+    /**
+     * @brief Matches a lexical token.
+     */
+    template<nonterminal DATA>
+    struct token
+    {
+        SYNTAX_MATCH
+        {
+            if(pos == tokens.cend() or pos->name != DATA)
+                return std::nullopt;
+            else
+                return ast(pos->name, pos, std::next(pos));
+        }
+    };
+
+    /**
+     * @brief Optionally matches another syntax.
+     */
+    template<typename DATA>
+    struct opt
+    {
+        SYNTAX_MATCH
+        {
+            std::optional<ast> result = DATA::match(tokens, pos);
+
+            if(result.has_value())
+                return result;
+            else
+                return ast(pos);
+        }
+    };
+
+    /**
+     * @brief Repeats the given syntax at least once.
+     */
+    template<typename DATA>
+    struct rep
+    {
+        SYNTAX_MATCH
+        {
+            ast output(pos);
+            std::optional<ast> result;
+
+            if(pos == tokens.cend())
+                return std::nullopt;
+
+            while(output.end != tokens.cend())
+            {
+                result = DATA::match(tokens, pos);
+
+                if(not result.has_value())
+                    break;
+
+                output.end = pos = result->end;
+
+                if(result->name.has_value())
+                    output.branches.push_back(std::move(*result));
+            }
+
+            if(output.begin == output.end)
+                return std::nullopt;
+            else
+                return output;
+        }
+    };
+
+    /**
+     * @brief Matches only one of the syntaxes given.
+     */
+    template<typename... DATA>
+    struct oneOf
+    {
+        SYNTAX_MATCH
+        {
+            std::optional<ast> result;
+
+            if(pos == tokens.cend())
+                return std::nullopt;
+
+            // Stops at the first alternative that matches
+            ((result = DATA::match(tokens, pos)).has_value() or ...);
+
+            return result;
+        }
+    };
+
+    /**
+     * @brief Matches all of the syntaxes given, in order.
+     */
+    template<typename... DATA>
+    struct list
+    {
+        SYNTAX_MATCH
+        {
+            ast output(pos);
+
+            if(pos == tokens.cend())
+                return std::nullopt;
+
+            // Stops at the first syntax that does not match
+            const bool matched = ([&]
+            {
+                std::optional<ast> result = DATA::match(tokens, pos);
+
+                if(not result.has_value())
+                    return false;
+
+                output.end = pos = result->end;
+
+                if(result->name.has_value())
+                    output.branches.push_back(std::move(*result));
+                else
+                    output.branches.insert(
+                        output.branches.end(),
+                        std::make_move_iterator(result->branches.begin()),
+                        std::make_move_iterator(result->branches.end())
+                    );
+
+                return true;
+            }() and ...);
+
+            if(matched)
+                return output;
+            else
+                return std::nullopt;
+        }
+    };
+
+    /**
+     * @brief Matches at least one of the given syntax delimited by a comma.
+     */
+    template<typename DATA>
+    struct csl
+    {
+        SYNTAX_MATCH
+        {
+            ast output(pos);
+            std::optional<ast> result;
+            bool onFirstMatch = true;
+
+            if(pos == tokens.cend())
+                return std::nullopt;
+
+            while(output.end != tokens.cend())
+            {
+                // Match a comma before matching the actual token every time except the first.
+                if(onFirstMatch)
+                    onFirstMatch = false;
+                else
+                {
+                    if(not lit<",">::match(tokens, pos).has_value())
+                        break;
+
+                    ++output.end;
+                    ++pos;
+                }
+
+                result = DATA::match(tokens, pos);
+
+                if(not result.has_value())
+                    break;
+
+                output.end = pos = result->end;
+
+                if(result->name.has_value())
+                    output.branches.push_back(std::move(*result));
+            }
+
+            if(output.begin == output.end)
+                return std::nullopt;
+            else
+                return output;
+        }
+    };
+
+    #undef SYNTAX_MATCH
+
+    /**
+     * @brief Equivalent of `LIST_WITH_SEPARATOR` in parse.cpp.
+     */
+    template<typename ITEM, typename SEPARATOR>
+    using listWithSeparator = list<
+        ITEM,
+        opt<rep<list<
+            SEPARATOR,
+            ITEM
+        >>>
+    >;
+
+    /**
+     * @brief Equivalents of `ABSTRACT_ARRAY_SUFFIX` and `ABSTRACT_FUNCTION_SUFFIX` in parse.cpp.
+     */
+    using abstractArraySuffix = list<
+        lit<"[">,
+        oneOf<
+            list<
+                opt<ref<typeQualifierList>>,
+                opt<ref<assignmentExpression>>
+            >,
+            list<
+                ref<storageClassSpecifierStatic>,
+                opt<ref<typeQualifierList>>,
+                ref<assignmentExpression>
+            >,
+            list<
+                ref<typeQualifierList>,
+                ref<storageClassSpecifierStatic>,
+                ref<assignmentExpression>
+            >,
+            list<
+                opt<ref<typeQualifierList>>,
+                ref<starModifier>
+            >
+        >,
+        lit<"]">
+    >;
+
+    using abstractFunctionSuffix = list<
+        lit<"(">,
+        opt<ref<parameterTypeList>>,
+        lit<")">
+    >;
+
+    #define RULE(NAME, ...) \
+        template<> \
+        struct rule<NAME> \
+        { \
+            using type = __VA_ARGS__; \
+        }
+
+    /*
+    Keep these in sync with `parse::nonterminals` in parse.cpp; the two grammars must produce identical ASTs.
+    */
+
+    RULE(operatorUnaryPositive, lit<"+">);
+
+    RULE(operatorUnaryNegate, lit<"-">);
+
+    RULE(operatorUnaryAddressOf, lit<"&">);
+
+    RULE(operatorUnaryDereference, lit<"*">);
+
+    RULE(operatorUnaryBitwiseNot, lit<"~">);
+
+    RULE(operatorUnaryLogicalNot, lit<"!">);
+
+    RULE(operatorIncrementPrefix, lit<"++">);
+
+    RULE(operatorDecrementPrefix, lit<"--">);
+
+    RULE(operatorAddition, lit<"+">);
+
+    RULE(operatorSubtraction, lit<"-">);
+
+    RULE(operatorMultiplication, lit<"*">);
+
+    RULE(operatorDivision, lit<"/">);
+
+    RULE(operatorModulo, lit<"%">);
+
+    RULE(operatorBitwiseLeftShift, lit<"<<">);
+
+    RULE(operatorBitwiseRightShift, lit<">>">);
+
+    RULE(operatorLessThan, lit<"<">);
+
+    RULE(operatorGreaterThan, lit<">">);
+
+    RULE(operatorLessThanOrEqualTo, lit<"<=">);
+
+    RULE(operatorGreaterThanOrEqualTo, lit<">=">);
+
+    RULE(operatorEqualTo, lit<"==">);
+
+    RULE(operatorNotEqualTo, lit<"!=">);
+
+    RULE(operatorLogicalAnd, lit<"&&">);
+
+    RULE(operatorLogicalOr, lit<"||">);
+
+    RULE(operatorBitwiseAnd, lit<"&">);
+
+    RULE(operatorBitwiseOr, lit<"|">);
+
+    RULE(operatorBitwiseXor, lit<"^">);
+
+    RULE(operatorMember, lit<".">);
+
+    RULE(operatorIndirect, lit<"->">);
+
+    RULE(operatorSizeof, lit<"sizeof">);
+
+    RULE(operatorIncrementPostfix, lit<"++">);
+
+    RULE(operatorDecrementPostfix, lit<"--">);
+
+    RULE(operatorAssign, lit<"=">);
+
+    RULE(operatorAssignMultiply, lit<"*=">);
+
+    RULE(operatorAssignDivide, lit<"/=">);
+
+    RULE(operatorAssignModulo, lit<"%=">);
+
+    RULE(operatorAssignAdd, lit<"+=">);
+
+    RULE(operatorAssignSubtract, lit<"-=">);
+
+    RULE(operatorAssignLeftShift, lit<"<<=">);
+
+    RULE(operatorAssignRightShift, lit<">>=">);
+
+    RULE(operatorAssignBitwiseAnd, lit<"&=">);
+
+    RULE(operatorAssignBitwiseOr, lit<"|=">);
+
+    RULE(operatorAssignBitwiseXor, lit<"^=">);
+
+    RULE(storageClassSpecifierExtern, lit<"extern">);
+
+    RULE(storageClassSpecifierRegister, lit<"register">);
+
+    RULE(storageClassSpecifierStatic, lit<"static">);
+
+    RULE(storageClassSpecifierThreadLocal, lit<"_Thread_local">);
+
+    RULE(storageClassSpecifierTypedef, lit<"typedef">);
+
+    RULE(typeSpecifierVoid, lit<"void">);
+
+    RULE(typeSpecifierChar, lit<"char">);
+
+    RULE(typeSpecifierShort, lit<"short">);
+
+    RULE(typeSpecifierInt, lit<"int">);
+
+    RULE(typeSpecifierLong, lit<"long">);
+
+    RULE(typeSpecifierFloat, lit<"float">);
+
+    RULE(typeSpecifierDouble, lit<"double">);
+
+    RULE(typeSpecifierSigned, lit<"signed">);
+
+    RULE(typeSpecifierUnsigned, lit<"unsigned">);
+
+    RULE(typeSpecifierBool, lit<"_Bool">);
+
+    RULE(struct_, lit<"struct">);
+
+    RULE(union_, lit<"union">);
+
+    RULE(typeQualifierConst, lit<"const">);
+
+    RULE(typeQualifierRestrict, lit<"restrict">);
+
+    RULE(typeQualifierVolatile, lit<"volatile">);
+
+    RULE(typeQualifierAtomic, lit<"_Atomic">);
+
+    RULE(functionSpecifierInline, lit<"inline">);
+
+    RULE(functionSpecifierNoReturn, lit<"_Noreturn">);
+
+    RULE(starModifier, lit<"*">);
+
+    RULE(varArgs, list<
+        lit<",">,
+        lit<"...">
+    >);
+
+    RULE(gotoStatement, list<
+        lit<"goto">,
+        token<identifier>,
+        lit<";">
+    >);
+
+    RULE(continueStatement, list<
+        lit<"continue">,
+        lit<";">
+    >);
+
+    RULE(breakStatement, list<
+        lit<"break">,
+        lit<";">
+    >);
+
+    RULE(returnStatement, list<
+        lit<"return">,
+        opt<ref<expression>>,
+        lit<";">
+    >);
+
+    RULE(whileStatement, list<
+        lit<"while">,
+        lit<"(">,
+        ref<expression>,
+        lit<")">,
+        ref<statement>
+    >);
+
+    RULE(doWhileStatement, list<
+        lit<"do">,
+        ref<statement>,
+        lit<"while">,
+        lit<"(">,
+        ref<expression>,
+        lit<")">,
+        ref<statement>
+    >);
+
+    RULE(forStatement, list<
+        lit<"for">,
+        lit<"(">,
+        opt<ref<expression>>,
+        lit<";">,
+        opt<ref<expression>>,
+        lit<";">,
+        opt<ref<expression>>,
+        lit<")">,
+        ref<statement>
+    >);
+
+    RULE(ifStatement, list<
+        lit<"if">,
+        lit<"(">,
+        ref<expression>,
+        lit<")">,
+        ref<statement>,
+        opt<list<
+            lit<"else">,
+            ref<statement>
+        >>
+    >);
+
+    RULE(switchStatement, list<
+        lit<"switch">,
+        lit<"(">,
+        ref<expression>,
+        lit<")">,
+        ref<statement>
+    >);
+
+    RULE(labelStatement, list<
+        token<identifier>,
+        lit<":">,
+        ref<statement>
+    >);
+
+    RULE(caseStatement, list<
+        lit<"case">,
+        ref<constantExpression>,
+        lit<":">,
+        ref<statement>
+    >);
+
+    RULE(defaultStatement, list<
+        lit<"default">,
+        lit<":">,
+        ref<statement>
+    >);
+
+    RULE(primaryExpression, oneOf<
+        token<identifier>,
+        token<constant>,
+        token<stringLiteral>,
+        list<
+            lit<"(">,
+            ref<expression>,
+            lit<")">
+        >,
+        ref<genericSelection>
+    >);
+
+    RULE(genericSelection, list<
+        lit<"_Generic">,
+        lit<"(">,
+        ref<assignmentExpression>,
+        lit<",">,
+        ref<genericAssocList>
+    >);
+
+    RULE(genericAssocList, csl<ref<genericAssociation>>);
+
+    RULE(genericAssociation, list<
+        oneOf<
+            ref<typeName>,
+            lit<"default">
+        >,
+        ref<assignmentExpression>
+    >);
+
+    RULE(postfixExpression, list<
+        oneOf<
+            ref<primaryExpression>,
+            list<
+                lit<"(">,
+                ref<typeName>,
+                lit<")">,
+                lit<"{">,
+                ref<initializerList>,
+                opt<lit<",">>,
+                lit<"}">
+            >
+        >,
+        opt<rep<oneOf<
+            list<
+                lit<"[">,
+                ref<expression>,
+                lit<"]">
+            >,
+            list<
+                lit<"(">,
+                opt<ref<argumentExpressionList>>,
+                lit<")">
+            >,
+            list<
+                oneOf<
+                    ref<operatorMember>,
+                    ref<operatorIndirect>
+                >,
+                token<identifier>
+            >,
+            ref<operatorIncrementPostfix>,
+            ref<operatorDecrementPostfix>
+        >>>
+    >);
+
+    RULE(argumentExpressionList, csl<ref<assignmentExpression>>);
+
+    RULE(unaryExpression, oneOf<
+        ref<postfixExpression>,
+        list<
+            oneOf<
+                ref<operatorIncrementPrefix>,
+                ref<operatorDecrementPrefix>
+            >,
+            ref<unaryExpression>
+        >,
+        list<
+            ref<unaryOperator>,
+            ref<castExpression>
+        >,
+        list<
+            ref<operatorSizeof>,
+            oneOf<
+                ref<unaryExpression>,
+                list<
+                    lit<"(">,
+                    ref<typeName>,
+                    lit<")">,
+                    lit<"_Alignof">,
+                    lit<"(">,
+                    ref<typeName>
+                >
+            >
+        >
+    >);
+
+    RULE(unaryOperator, oneOf<
+        ref<operatorUnaryPositive>,
+        ref<operatorUnaryNegate>,
+        ref<operatorUnaryAddressOf>,
+        ref<operatorUnaryDereference>,
+        ref<operatorUnaryBitwiseNot>,
+        ref<operatorUnaryLogicalNot>
+    >);
+
+    RULE(castExpression, oneOf<
+        ref<unaryExpression>,
+        list<
+            lit<"(">,
+            ref<typeName>,
+            lit<")">,
+            ref<castExpression>
+        >
+    >);
+
+    RULE(multiplicativeExpression, listWithSeparator<
+        ref<castExpression>,
+        oneOf<
+            ref<operatorMultiplication>,
+            ref<operatorDivision>,
+            ref<operatorModulo>
+        >
+    >);
+
+    RULE(additiveExpression, listWithSeparator<
+        ref<multiplicativeExpression>,
+        oneOf<
+            ref<operatorAddition>,
+            ref<operatorSubtraction>
+        >
+    >);
+
+    RULE(shiftExpression, listWithSeparator<
+        ref<additiveExpression>,
+        oneOf<
+            ref<operatorBitwiseLeftShift>,
+            ref<operatorBitwiseRightShift>
+        >
+    >);
+
+    RULE(relationalExpression, listWithSeparator<
+        ref<shiftExpression>,
+        oneOf<
+            ref<operatorLessThan>,
+            ref<operatorGreaterThan>,
+            ref<operatorLessThanOrEqualTo>,
+            ref<operatorGreaterThanOrEqualTo>
+        >
+    >);
+
+    RULE(equalityExpression, listWithSeparator<
+        ref<relationalExpression>,
+        oneOf<
+            ref<operatorEqualTo>,
+            ref<operatorNotEqualTo>
+        >
+    >);
+
+    RULE(bitwiseAndExpression, listWithSeparator<
+        ref<equalityExpression>,
+        ref<operatorBitwiseAnd>
+    >);
+
+    RULE(bitwiseXorExpression, listWithSeparator<
+        ref<bitwiseAndExpression>,
+        ref<operatorBitwiseXor>
+    >);
+
+    RULE(bitwiseOrExpression, listWithSeparator<
+        ref<bitwiseXorExpression>,
+        ref<operatorBitwiseOr>
+    >);
+
+    RULE(logicalAndExpression, listWithSeparator<
+        ref<bitwiseOrExpression>,
+        ref<operatorLogicalAnd>
+    >);
+
+    RULE(logicalOrExpression, listWithSeparator<
+        ref<logicalAndExpression>,
+        ref<operatorLogicalOr>
+    >);
+
+    RULE(conditionalExpression, list<
+        ref<logicalOrExpression>,
+        opt<list<
+            lit<"?">,
+            ref<expression>,
+            lit<":">,
+            ref<conditionalExpression>
+        >>
+    >);
+
+    RULE(assignmentExpression, list<
+        opt<rep<list<
+            ref<unaryExpression>,
+            oneOf<
+                ref<operatorAssign>,
+                ref<operatorAssignMultiply>,
+                ref<operatorAssignDivide>,
+                ref<operatorAssignModulo>,
+                ref<operatorAssignAdd>,
+                ref<operatorAssignSubtract>,
+                ref<operatorAssignLeftShift>,
+                ref<operatorAssignRightShift>,
+                ref<operatorAssignBitwiseAnd>,
+                ref<operatorAssignBitwiseOr>,
+                ref<operatorAssignBitwiseXor>
+            >
+        >>>,
+        ref<conditionalExpression>
+    >);
+
+    RULE(expression, csl<ref<assignmentExpression>>);
+
+    RULE(constantExpression, ref<conditionalExpression>);
+
+    RULE(declaration, oneOf<
+        list<
+            ref<declarationSpecifiers>,
+            opt<ref<initDeclaratorList>>,
+            lit<";">
+        >,
+        ref<staticAssertDeclaration>
+    >);
+
+    RULE(declarationSpecifiers, rep<oneOf<
+        ref<storageClassSpecifier>,
+        ref<typeSpecifier>,
+        ref<typeQualifier>,
+        ref<functionSpecifier>,
+        ref<alignmentSpecifier>
+    >>);
+
+    RULE(initDeclaratorList, csl<ref<initDeclarator>>);
+
+    RULE(initDeclarator, list<
+        ref<declarator>,
+        opt<list<
+            lit<"=">,
+            ref<initializer>
+        >>
+    >);
+
+    RULE(storageClassSpecifier, oneOf<
+        ref<storageClassSpecifierExtern>,
+        ref<storageClassSpecifierRegister>,
+        ref<storageClassSpecifierStatic>,
+        ref<storageClassSpecifierThreadLocal>,
+        ref<storageClassSpecifierTypedef>
+    >);
+
+    RULE(typeSpecifier, oneOf<
+        ref<typeSpecifierVoid>,
+        ref<typeSpecifierChar>,
+        ref<typeSpecifierShort>,
+        ref<typeSpecifierInt>,
+        ref<typeSpecifierLong>,
+        ref<typeSpecifierFloat>,
+        ref<typeSpecifierDouble>,
+        ref<typeSpecifierSigned>,
+        ref<typeSpecifierUnsigned>,
+        ref<typeSpecifierBool>
+    >);
+
+    RULE(structOrUnionSpecifier, list<
+        ref<structOrUnion>,
+        oneOf<
+            token<identifier>,
+            list<
+                opt<token<identifier>>,
+                lit<"{">,
+                ref<structDeclarationList>,
+                lit<"}">
+            >
+        >
+    >);
+
+    RULE(structOrUnion, oneOf<
+        ref<struct_>,
+        ref<union_>
+    >);
+
+    RULE(structDeclarationList, rep<ref<structDeclaration>>);
+
+    RULE(structDeclaration, oneOf<
+        list<
+            ref<specifierQualifierList>,
+            opt<ref<structDeclaratorList>>,
+            lit<";">
+        >,
+        ref<staticAssertDeclaration>
+    >);
+
+    RULE(specifierQualifierList, rep<oneOf<
+        ref<typeSpecifier>,
+        ref<typeQualifier>,
+        ref<alignmentSpecifier>
+    >>);
+
+    RULE(structDeclaratorList, csl<ref<structDeclarator>>);
+
+    RULE(structDeclarator, oneOf<
+        ref<declarator>,
+        list<
+            opt<ref<declarator>>,
+            lit<":">,
+            ref<constantExpression>
+        >
+    >);
+
+    RULE(enumSpecifier, list<
+        lit<"enum">,
+        oneOf<
+            token<identifier>,
+            list<
+                opt<token<identifier>>,
+                lit<"{">,
+                ref<enumeratorList>,
+                opt<lit<",">>,
+                lit<"}">
+            >
+        >
+    >);
+
+    RULE(enumeratorList, csl<ref<enumerator>>);
+
+    RULE(enumerator, list<
+        token<identifier>,
+        opt<list<
+            lit<"=">,
+            ref<constantExpression>
+        >>
+    >);
+
+    RULE(atomicTypeSpecifier, list<
+        lit<"_Atomic">,
+        lit<"(">,
+        ref<typeName>,
+        lit<")">
+    >);
+
+    RULE(typeQualifier, oneOf<
+        ref<typeQualifierConst>,
+        ref<typeQualifierRestrict>,
+        ref<typeQualifierVolatile>,
+        ref<typeQualifierAtomic>
+    >);
+
+    RULE(functionSpecifier, oneOf<
+        ref<functionSpecifierInline>,
+        ref<functionSpecifierNoReturn>
+    >);
+
+    RULE(alignmentSpecifier, list<
+        lit<"_Alignas">,
+        lit<"(">,
+        oneOf<
+            ref<typeName>,
+            ref<constantExpression>
+        >,
+        lit<")">
+    >);
+
+    RULE(declarator, list<
+        opt<ref<pointer>>,
+        ref<directDeclarator>
+    >);
+
+    RULE(directDeclarator, list<
+        oneOf<
+            token<identifier>,
+            list<
+                lit<"(">,
+                ref<declarator>,
+                lit<")">
+            >
+        >,
+        opt<rep<oneOf<
+            list<
+                lit<"(">,
+                ref<parameterTypeList>,
+                lit<")">
+            >,
+            list<
+                lit<"[">,
+                oneOf<
+                    list<
+                        opt<ref<typeQualifierList>>,
+                        opt<ref<assignmentExpression>>
+                    >,
+                    list<
+                        ref<storageClassSpecifierStatic>,
+                        opt<ref<typeQualifierList>>,
+                        ref<assignmentExpression>
+                    >,
+                    list<
+                        ref<typeQualifierList>,
+                        ref<storageClassSpecifierStatic>,
+                        opt<ref<assignmentExpression>>
+                    >,
+                    list<
+                        opt<ref<typeQualifierList>>,
+                        ref<starModifier>
+                    >
+                >,
+                lit<"]">
+            >
+        >>>
+    >);
+
+    RULE(pointer, list<
+        lit<"*">,
+        opt<ref<typeQualifierList>>,
+        opt<ref<pointer>>
+    >);
+
+    RULE(typeQualifierList, rep<ref<typeQualifier>>);
+
+    RULE(parameterTypeList, list<
+        ref<parameterList>,
+        opt<ref<varArgs>>
+    >);
+
+    RULE(parameterList, csl<ref<parameterDeclaration>>);
+
+    RULE(parameterDeclaration, list<
+        ref<declarationSpecifiers>,
+        oneOf<
+            ref<declarator>,
+            opt<ref<abstractDeclarator>>
+        >
+    >);
+
+    RULE(typeName, list<
+        ref<specifierQualifierList>,
+        opt<ref<abstractDeclarator>>
+    >);
+
+    RULE(abstractDeclarator, oneOf<
+        ref<pointer>,
+        list<
+            opt<ref<pointer>>,
+            ref<directAbstractDeclarator>
+        >
+    >);
+
+    RULE(directAbstractDeclarator, list<
+        oneOf<
+            list<
+                lit<"(">,
+                ref<abstractDeclarator>,
+                lit<")">
+            >,
+            abstractArraySuffix,
+            abstractFunctionSuffix
+        >,
+        opt<rep<oneOf<
+            abstractArraySuffix,
+            abstractFunctionSuffix
+        >>>
+    >);
+
+    // There is no typedef table here, so `typeSpecifier` leaves typedef names out and every identifier is an ordinary one; the two grammars agree on code without typedefs
+    RULE(typedefName, token<identifier>);
+
+    RULE(initializer, oneOf<
+        ref<assignmentExpression>,
+        list<
+            lit<"{">,
+            ref<initializerList>,
+            opt<lit<",">>,
+            lit<"}">
+        >
+    >);
+
+    RULE(initializerList, csl<list<
+        opt<ref<designation>>,
+        ref<initializer>
+    >>);
+
+    RULE(designation, list<
+        ref<designatorList>,
+        lit<"=">
+    >);
+
+    RULE(designatorList, rep<ref<designator>>);
+
+    RULE(designator, oneOf<
+        list<
+            lit<"[">,
+            ref<constantExpression>,
+            lit<"]">
+        >,
+        list<
+            lit<".">,
+            token<identifier>
+        >
+    >);
+
+    RULE(staticAssertDeclaration, list<
+        lit<"_Static_assert">,
+        lit<"(">,
+        ref<constantExpression>,
+        lit<",">,
+        token<stringLiteral>,
+        lit<")">,
+        lit<";">
+    >);
+
+    RULE(statement, oneOf<
+        ref<labelStatement>,
+        ref<caseStatement>,
+        ref<defaultStatement>,
+        ref<compoundStatement>,
+        ref<expressionStatement>,
+        ref<ifStatement>,
+        ref<switchStatement>,
+        ref<gotoStatement>,
+        ref<continueStatement>,
+        ref<breakStatement>,
+        ref<returnStatement>
+    >);
+
+    RULE(compoundStatement, list<
+        lit<"{">,
+        opt<ref<declarationList>>,
+        opt<ref<statementList>>,
+        lit<"}">
+    >);
+
+    RULE(declarationList, rep<ref<declaration>>);
+
+    RULE(statementList, rep<ref<statement>>);
+
+    RULE(expressionStatement, list<
+        opt<ref<expression>>,
+        lit<";">
+    >);
+
+    RULE(translationUnit, rep<ref<externalDeclaration>>);
+
+    RULE(externalDeclaration, oneOf<
+        ref<functionDefinition>,
+        ref<declaration>
+    >);
+
+    RULE(functionDefinition, list<
+        opt<ref<declarationSpecifiers>>,
+        ref<declarator>,
+        opt<ref<declarationList>>,
+        ref<compoundStatement>
+    >);
+
+    #undef RULE
+
+    /**
+     * @brief Matches the nonterminal `NAME` beginning at `pos`. Equivalent to `parse::nonterminals[NAME]->match(tokens, pos)`.
+     */
+    template<nonterminal NAME>
+    inline std::optional<ast> match(
+        const std::vector<lexer::token>& tokens,
+        const std::vector<lexer::token>::const_iterator pos
+    ) noexcept
+    {
+        return rule<NAME>::type::match(tokens, pos);
+    }
+}